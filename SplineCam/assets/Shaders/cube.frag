@@ -0,0 +1,10 @@
+#version 330 core
+
+in vec4 instanceColor;
+
+out vec4 frag_color;
+
+void main()
+{
+	frag_color = instanceColor;
+}
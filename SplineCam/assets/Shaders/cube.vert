@@ -0,0 +1,17 @@
+#version 330 core
+
+layout (location = 0) in vec3 pos;
+
+// per-instance data
+layout (location = 1) in mat4 model;
+layout (location = 5) in vec4 color;
+
+uniform mat4 viewProjection;
+
+out vec4 instanceColor;
+
+void main()
+{
+	gl_Position = viewProjection * model * vec4(pos, 1.0f);
+	instanceColor = color;
+}
@@ -0,0 +1,13 @@
+#version 330 core
+
+flat in int isHighlighted;
+
+out vec4 frag_color;
+
+uniform vec4 color;
+uniform vec4 highlightColor;
+
+void main()
+{
+	frag_color = isHighlighted != 0 ? highlightColor : color;
+}
@@ -0,0 +1,16 @@
+#version 330 core
+
+layout (location = 0) in vec3 pos;
+
+uniform mat4 modelViewProjection;
+
+// the vertices [x, y) are drawn with the highlight color
+uniform ivec2 highlightRange;
+
+flat out int isHighlighted;
+
+void main()
+{
+	gl_Position = modelViewProjection * vec4(pos, 1.0f);
+	isHighlighted = (gl_VertexID >= highlightRange.x && gl_VertexID < highlightRange.y) ? 1 : 0;
+}
@@ -0,0 +1,333 @@
+// Microbenchmarks of the hot paths of Spline, linked against the headless SplineCore library only.
+//
+// Usage: SplineBench [--json <file>] [--max-points <n>] [--min-time <ms>]
+//	Times each benchmark over paths of 10 up to max-points control points, and prints ns/op and allocations/op.
+//	With --json, the results are also written to <file>, so they can be diffed between builds.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "SplineCore/Spline.h"
+#include "SplineCore/StreamingSpline.h"
+#include "SplineCore/SplineFitter.h"
+#include "SplineCore/SplineDecimator.h"
+
+// Counts the allocations made through the global operator new
+static size_t s_allocationCount = 0;
+
+void* operator new(size_t size)
+{
+	s_allocationCount++;
+	void* p = malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// Keeps the results of the benchmarked calls alive, so they are not optimized away
+static volatile float s_sink = 0.0f;
+
+struct BenchmarkResult
+{
+	std::string name;
+	size_t controlPoints;
+	size_t iterations;
+	double nsPerOp;
+	double allocationsPerOp;
+};
+
+// Runs body(iterations), doubling the iterations until it takes at least minTime, and records the last run
+template <typename Body>
+BenchmarkResult Run(const char* name, size_t controlPoints, double minTime, Body body)
+{
+	size_t iterations = 1;
+	for (;;) {
+		size_t allocations = s_allocationCount;
+		auto start = std::chrono::steady_clock::now();
+		body(iterations);
+		double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		allocations = s_allocationCount - allocations;
+
+		if (elapsed >= minTime || iterations >= (size_t(1) << 30))
+			return { name, controlPoints, iterations, elapsed / iterations, (double)allocations / iterations };
+		iterations *= 2;
+	}
+}
+
+// A reproducible winding path, with a custom orientation on every fourth control point
+void MakePath(size_t count, std::vector<glm::vec3>& points, std::vector<glm::vec3>& orientations)
+{
+	unsigned int seed = 12345;
+	auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / 16777216.0f - 0.5f; };
+
+	points.resize(count);
+	orientations.assign(count, glm::vec3());
+	for (size_t i = 0; i < count; i++) {
+		float a = i * 0.7f;
+		points[i] = glm::vec3(20.0f * cosf(a) + 5.0f * random(), 5.0f * sinf(a * 0.3f) + 5.0f * random(), i * 3.0f);
+		if (i % 4 == 0)
+			orientations[i] = glm::normalize(glm::vec3(random(), random(), 1.0f));
+	}
+}
+
+const char* SimdTarget()
+{
+#if defined(SPLINE_BATCH_AVX)
+	return "avx";
+#elif defined(SPLINE_BATCH_SSE)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+int main(int argc, char** argv)
+{
+	const char* jsonPath = nullptr;
+	size_t maxPoints = 1000000;
+	double minTime = 100.0 * 1e6;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--json") && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (!strcmp(argv[i], "--max-points") && i + 1 < argc)
+			maxPoints = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--min-time") && i + 1 < argc)
+			minTime = atof(argv[++i]) * 1e6;
+		else {
+			std::cerr << "Usage: " << argv[0] << " [--json <file>] [--max-points <n>] [--min-time <ms>]" << std::endl;
+			return 1;
+		}
+	}
+
+	const size_t batchSize = 1024;
+	std::vector<float> parameters(batchSize), x(batchSize), y(batchSize), z(batchSize), tx(batchSize), ty(batchSize), tz(batchSize);
+	for (size_t k = 0; k < batchSize; k++)
+		parameters[k] = (k * 0.6180339887f) - (int)(k * 0.6180339887f);
+
+	std::vector<BenchmarkResult> results;
+	for (size_t count = 10; count <= maxPoints; count *= 10) {
+		std::vector<glm::vec3> points, orientations;
+		MakePath(count, points, orientations);
+
+		Spline<> spline;
+		spline.Init(points, orientations);
+
+		// Builds the whole spline: its coefficients, points and arc-length table
+		results.push_back(Run("init", count, minTime, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; i++) {
+				spline.Init(points, orientations);
+				s_sink = spline.GetLength();
+			}
+		}));
+
+		// The same with a fixed budget of 16 points per control point, refined globally where the curve is least flat
+		Spline<> budgetedSpline;
+		budgetedSpline.SetSampleBudget(16 * count);
+		results.push_back(Run("init_budgeted", count, minTime, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; i++) {
+				budgetedSpline.Init(points, orientations);
+				s_sink = budgetedSpline.GetLength();
+			}
+		}));
+
+		// Fits a spline with a sixteenth as many control points to its points sampled at as many times, timed per sample
+		std::vector<double> sampleTimes(count);
+		std::vector<glm::vec3> samples(count), fittedPoints;
+		for (size_t k = 0; k < count; k++) {
+			sampleTimes[k] = k / 120.0;
+			samples[k] = spline.GetPoint((float)k / (count - 1));
+		}
+		BenchmarkResult fit = Run("fit", count, minTime, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; i++) {
+				SplineFitter::Fit(sampleTimes.data(), samples.data(), count, (unsigned int)(count / 16 + 4), fittedPoints);
+				s_sink = fittedPoints[0].x;
+			}
+		});
+		fit.nsPerOp /= count;
+		fit.allocationsPerOp /= count;
+		results.push_back(fit);
+
+		// Decimates a path through the same samples back within a hundredth of a unit, timed per control point
+		std::vector<glm::vec3> decimatedPoints, decimatedOrientations;
+		BenchmarkResult decimate = Run("decimate", count, minTime, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; i++) {
+				SplineDecimator<>::Decimate(samples, std::vector<glm::vec3>(), false, 0.01f, decimatedPoints, decimatedOrientations);
+				s_sink = decimatedPoints[0].x;
+			}
+		});
+		decimate.nsPerOp /= count;
+		decimate.allocationsPerOp /= count;
+		results.push_back(decimate);
+
+		// All the coordinates are summed, as the batched evaluation writes them all, so that none of them is optimized away here
+		results.push_back(Run("get_point", count, minTime, [&](size_t iterations) {
+			float sum = 0.0f;
+			for (size_t i = 0; i < iterations; i++) {
+				glm::vec3 point = spline.GetPoint(parameters[i % batchSize]);
+				sum += point.x + point.y + point.z;
+			}
+			s_sink = sum;
+		}));
+
+		// The tangent blended with the custom orientations
+		results.push_back(Run("get_tangent", count, minTime, [&](size_t iterations) {
+			float sum = 0.0f;
+			for (size_t i = 0; i < iterations; i++)
+				sum += spline.GetTangent(parameters[i % batchSize]).x;
+			s_sink = sum;
+		}));
+
+		results.push_back(Run("get_frame", count, minTime, [&](size_t iterations) {
+			float sum = 0.0f;
+			glm::vec3 forward, up;
+			for (size_t i = 0; i < iterations; i++) {
+				spline.GetFrame(parameters[i % batchSize], forward, up);
+				sum += up.x;
+			}
+			s_sink = sum;
+		}));
+
+		// Batched evaluations, timed per evaluated parameter
+		SplineBatchOutput pointsOutput;
+		pointsOutput.x = x.data(); pointsOutput.y = y.data(); pointsOutput.z = z.data();
+		BenchmarkResult batch = Run("get_point_batch", count, minTime, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; i++)
+				spline.EvaluateBatch(parameters.data(), batchSize, pointsOutput);
+			s_sink = x[0];
+		});
+		batch.nsPerOp /= batchSize;
+		batch.allocationsPerOp /= batchSize;
+		results.push_back(batch);
+
+		SplineBatchOutput tangentsOutput;
+		tangentsOutput.tangentX = tx.data(); tangentsOutput.tangentY = ty.data(); tangentsOutput.tangentZ = tz.data();
+		batch = Run("get_tangent_batch", count, minTime, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; i++)
+				spline.EvaluateBatch(parameters.data(), batchSize, tangentsOutput);
+			s_sink = tx[0];
+		});
+		batch.nsPerOp /= batchSize;
+		batch.allocationsPerOp /= batchSize;
+		results.push_back(batch);
+
+		// Positions around the path, projected onto it on a single thread
+		results.push_back(Run("closest_point", count, minTime, [&](size_t iterations) {
+			float sum = 0.0f;
+			for (size_t i = 0; i < iterations; i++) {
+				size_t k = i % batchSize;
+				sum += spline.ClosestPoint(points[k % count] + glm::vec3(x[k], 1.0f, -1.0f)).t;
+			}
+			s_sink = sum;
+		}));
+
+		// A step of playback along the path streamed from a generator, by distance, including the reading and dropping of chunks it triggers
+		results.push_back(Run("stream_playback", count, minTime, [&](size_t iterations) {
+			size_t next = 0;
+			auto generate = [&](glm::vec3& outControlPoint, glm::vec3& outOrientation) {
+				if (next == count)
+					return false;
+				outControlPoint = points[next];
+				outOrientation = orientations[next];
+				next++;
+				return true;
+			};
+			SplineGeneratorChunkSource source;
+			source.Init(generate);
+			StreamingSpline<> stream;
+			stream.Init(&source);
+
+			// About 4 steps per section, starting over at the end of the path
+			double distance = 0.0, step = spline.GetLength() / (4.0 * count);
+			glm::vec3 forward, up;
+			float sum = 0.0f;
+			for (size_t i = 0; i < iterations; i++) {
+				distance += step;
+				if (stream.IsEnded() && distance > stream.EndDistance()) {
+					next = 0;
+					source.Init(generate);
+					stream.Init(&source);
+					distance = 0.0;
+				}
+				double s = stream.GetParameterAtDistance(distance);
+				stream.Update(s);
+				stream.GetFrame(s, forward, up);
+				sum += stream.GetPoint(s).x + up.x;
+			}
+			s_sink = sum;
+		}));
+
+		results.push_back(Run("get_length", count, minTime, [&](size_t iterations) {
+			float sum = 0.0f;
+			for (size_t i = 0; i < iterations; i++)
+				sum += spline.GetLength();
+			s_sink = sum;
+		}));
+
+		// One edit and the recompute it triggers on the next read, moving the control point back and forth
+		results.push_back(Run("translate_edit", count, minTime, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; i++) {
+				spline.TranslateControlPoint(glm::vec3(0.0f, (i & 1) ? -1.0f : 1.0f, 0.0f));
+				s_sink = spline.GetLength();
+				if (i & 1)
+					spline.NextControlPoint();
+			}
+		}));
+
+		// The same always on the control point in the middle of the path, which only recomputes the sections around it,
+		//	so it should take as long on any number of control points
+		spline.SelectControlPoint(count / 2);
+		results.push_back(Run("translate_edit_middle", count, minTime, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; i++) {
+				spline.TranslateControlPoint(glm::vec3(0.0f, (i & 1) ? -1.0f : 1.0f, 0.0f));
+				s_sink = spline.GetLength();
+			}
+		}));
+	}
+
+	printf("%-22s %12s %12s %14s %10s\n", "benchmark", "points", "iterations", "ns/op", "allocs/op");
+	for (auto& result : results)
+		printf("%-22s %12zu %12zu %14.2f %10.2f\n", result.name.c_str(), result.controlPoints, result.iterations, result.nsPerOp, result.allocationsPerOp);
+
+	// How much longer a single edit takes on the longest path than on the shortest one, which should stay close to 1
+	for (const char* name : { "translate_edit", "translate_edit_middle" }) {
+		const BenchmarkResult* shortest = nullptr;
+		const BenchmarkResult* longest = nullptr;
+		for (auto& result : results) {
+			if (result.name != name)
+				continue;
+			if (!shortest)
+				shortest = &result;
+			longest = &result;
+		}
+		if (shortest && longest != shortest)
+			printf("%s: %.2fx as long on %zu control points as on %zu\n", name, longest->nsPerOp / shortest->nsPerOp,
+				longest->controlPoints, shortest->controlPoints);
+	}
+
+	if (jsonPath) {
+		std::ofstream json(jsonPath);
+		if (!json) {
+			std::cerr << "Could not open " << jsonPath << std::endl;
+			return 1;
+		}
+		json << "{\n\t\"simd\": \"" << SimdTarget() << "\",\n\t\"results\": [\n";
+		for (size_t i = 0; i < results.size(); i++) {
+			const BenchmarkResult& result = results[i];
+			json << "\t\t{ \"name\": \"" << result.name << "\", \"controlPoints\": " << result.controlPoints
+				<< ", \"iterations\": " << result.iterations << ", \"nsPerOp\": " << result.nsPerOp
+				<< ", \"allocationsPerOp\": " << result.allocationsPerOp << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+		}
+		json << "\t]\n}\n";
+	}
+
+	return 0;
+}
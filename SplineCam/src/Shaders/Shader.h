@@ -79,6 +79,12 @@ public:
 
 	// Add any SetUniform needed below... 
 
+	void SetUniform(GLchar* name, const glm::ivec2& v)
+	{
+		GLint location = GetUniformLocation(name);
+		glUniform2i(location, v.x, v.y);
+	}
+
 	void SetUniform(GLchar* name, const glm::vec3& v)
 	{
 		GLint location = GetUniformLocation(name);
@@ -77,6 +77,17 @@ public:
 		UpdateCameraVectors();
 	}
 
+	// Sets the ray from the near plane through the given point of the window, from its top left corner, in the units of its width and height
+	void GetRay(double x, double y, int width, int height, glm::vec3& origin, glm::vec3& direction) const
+	{
+		glm::mat4 inverse = glm::inverse(ViewProjectionMatrix());
+		float ndcX = (float)(2.0 * x / width - 1.0), ndcY = (float)(1.0 - 2.0 * y / height);
+		glm::vec4 nearPoint = inverse * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+		glm::vec4 farPoint = inverse * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+		origin = glm::vec3(nearPoint) / nearPoint.w;
+		direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+	}
+
 	glm::mat3 GetAxis() { return glm::mat3(right, up, forward);	}
 	glm::vec3 GetPosition() { return pos; }
 
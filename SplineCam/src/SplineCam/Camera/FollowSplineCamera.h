@@ -2,7 +2,7 @@
 #define FOLLOW_SPLINE_CAMERA_H
 
 #include "Camera.h"
-#include "../Spline/Spline.h"
+#include "../../SplineCore/StreamingSpline.h"
 
 class FollowSplineCamera : public Camera
 {
@@ -10,12 +10,24 @@ public:
 	FollowSplineCamera() {}
 	~FollowSplineCamera() {}
 
-	void Init(const Spline* spline, float fov, float aspect, float zNear, float zFar)
+	void Init(const Spline<>* spline, float fov, float aspect, float zNear, float zFar)
 	{
 		this->spline = spline;
+		this->streamingSpline = nullptr;
 		Camera::Init(spline->GetPoint(t), glm::normalize(spline->GetTangent(t)), fov, aspect, zNear, zFar);
 	}
 
+	// Follows a streamed spline instead, from the start of its window, pulling its chunks ahead of the camera as it moves.
+	// It stops at the end of the stream, and rewinding stops at the oldest section still kept.
+	void Init(StreamingSpline<>* streamingSpline, float fov, float aspect, float zNear, float zFar)
+	{
+		this->spline = nullptr;
+		this->streamingSpline = streamingSpline;
+		distance = streamingSpline->StartDistance();
+		s = streamingSpline->GetParameterAtDistance(distance);
+		Camera::Init(streamingSpline->GetPoint(s), glm::normalize(streamingSpline->GetTangent(s)), fov, aspect, zNear, zFar);
+	}
+
 	void Update(float deltaTime) override
 	{
 		if (spline)
@@ -26,10 +38,26 @@ public:
 
 			if (!isPaused || doRewind || doFastForward) {
 				int step = doRewind ? -1 : !isPaused + doFastForward;
-				t += 10.0f * step * deltaTime * (1/spline->GetLength());
-				if (t < 0)
-					t += (int)t + 1;
-				t = fmodf(t, 1);
+
+				// advance at constant speed along the arc length, looping at both ends
+				float length = spline->GetLength();
+				float distance = fmodf(spline->GetDistanceAtParameter(t) + 10.0f * step * deltaTime, length);
+				if (distance < 0)
+					distance += length;
+				t = spline->GetParameterAtDistance(distance);
+			}
+		}
+		else if (streamingSpline)
+		{
+			Move(streamingSpline->GetPoint(s) - pos);
+
+			if (!isPaused || doRewind || doFastForward) {
+				int step = doRewind ? -1 : !isPaused + doFastForward;
+
+				// advance at constant speed along the arc length, within the window of the stream
+				distance = glm::clamp(distance + 10.0 * step * deltaTime, streamingSpline->StartDistance(), streamingSpline->EndDistance());
+				s = streamingSpline->GetParameterAtDistance(distance);
+				streamingSpline->Update(s);
 			}
 		}
 	}
@@ -41,15 +69,15 @@ private:
 
 	void UpdateCameraVectors() override
 	{
-		// set the forward vector according to the tangent
-		glm::vec3 tangent = spline->GetTangent(t);
-		forward = glm::normalize(tangent);
-
-		// set the right vector by crossing the forward with the Y axis
-		right = glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f));
+		// set the forward and up vectors from the rotation-minimizing frames of the spline,
+		//	so the camera keeps a steady roll through vertical sections and loops
+		if (spline)
+			spline->GetFrame(t, forward, up);
+		else
+			streamingSpline->GetFrame(s, forward, up);
 
-		// set the up vector by crossing the forward and right vector
-		up = glm::cross(right, forward);
+		// set the right vector by crossing the forward and up vectors
+		right = glm::cross(forward, up);
 
 		// set the new focus position
 		focusPos = pos + forward;
@@ -58,10 +86,15 @@ private:
 private:
 
 	// spline
-	const Spline* spline;
+	const Spline<>* spline = nullptr;
 
 	// animatedPoint
 	float t = 0.0f;
+
+	// streamed spline, followed instead of the spline if set, and the position and distance along it of the animated point
+	StreamingSpline<>* streamingSpline = nullptr;
+	double s = 0.0;
+	double distance = 0.0;
 };
 
 #endif // !FOLLOW_SPLINE_CAMERA_H
@@ -1,8 +1,11 @@
 #ifndef SPLINE_MANAGER_H
 #define SPLINE_MANAGER_H
 
-#include "Spline.h"
+#include "../../SplineCore/Spline.h"
+#include "../../SplineCore/SplineImporter.h"
+#include "../../SplineCore/SplineDecimator.h"
 #include <vector>
+#include <string>
 
 class SplineManager
 {
@@ -27,15 +30,38 @@ public:
 		}
 	}
 
-	Spline* GetSpline(unsigned index)
+	Spline<>* GetSpline(unsigned index)
 	{
-		Spline* spline = nullptr;
+		Spline<>* spline = nullptr;
 		if (index < splines.size())
 		{
 			spline = &splines[index];
 
 			if (spline->ControlPoints().size() == 0) {
-				// The spline is not initialized so init with some random points
+				// The spline is not initialized so load it from its file, if it was saved before with enough control points to edit
+				SplineFileView file;
+				if (file.Open(GetSplinePath(index).c_str()) && file.ControlPointCount() >= MinimumControlPoints && spline->Init(file))
+					return spline;
+
+				// or import its control points from a CSV or JSON export, decimated to edit them interactively
+				std::vector<glm::vec3> controlPoints, orientations;
+				for (const char* extension : { ".csv", ".json" }) {
+					std::string path = GetImportPath(index, extension);
+					if (SplineImporter::Import(path.c_str(), controlPoints, orientations) && controlPoints.size() >= MinimumControlPoints) {
+						printf("Imported %zu control points from %s\n", controlPoints.size(), path.c_str());
+						if (controlPoints.size() > ImportDecimationThreshold) {
+							std::vector<glm::vec3> decimatedControlPoints, decimatedOrientations;
+							float error = SplineDecimator<>::Decimate(controlPoints, orientations, false, ImportTolerance, decimatedControlPoints, decimatedOrientations);
+							printf("Decimated them to %zu control points, within %f\n", decimatedControlPoints.size(), error);
+							controlPoints.swap(decimatedControlPoints);
+							orientations.swap(decimatedOrientations);
+						}
+						spline->Init(controlPoints, orientations, false);
+						return spline;
+					}
+				}
+
+				// or else init with some random points
 				spline->Init(std::vector<glm::vec3>({
 					glm::vec3(3.08f, 0.75f, -15.0f),
 					glm::vec3(22.66f, 0.64f, -12.43f),
@@ -53,6 +79,24 @@ public:
 		return spline;
 	}
 
+	// Saves the spline to its file, to be loaded instead of the default points the next time
+	bool SaveSpline(unsigned index)
+	{
+		bool isSaved = index < splines.size() && splines[index].Save(GetSplinePath(index).c_str());
+		printf(isSaved ? "Saved spline to %s\n" : "Could not save spline to %s\n", GetSplinePath(index).c_str());
+		return isSaved;
+	}
+
+	static std::string GetSplinePath(unsigned index)
+	{
+		return "assets/spline" + std::to_string(index) + ".spline";
+	}
+
+	static std::string GetImportPath(unsigned index, const char* extension)
+	{
+		return "assets/spline" + std::to_string(index) + extension;
+	}
+
 	~SplineManager(){}
 
 protected:
@@ -64,7 +108,14 @@ protected:
 
 private:
 
-	std::vector<Spline> splines;
+	// Saved and imported splines with fewer control points than this are ignored
+	static constexpr size_t MinimumControlPoints = 4;
+
+	// Imports with more control points than this are decimated, keeping their curve within the tolerance of the imported one
+	static constexpr size_t ImportDecimationThreshold = 10000;
+	static constexpr float ImportTolerance = 0.01f;
+
+	std::vector<Spline<>> splines;
 
 	int numSplines = 0;
 	static SplineManager* s_instance;
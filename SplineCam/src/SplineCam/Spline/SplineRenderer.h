@@ -0,0 +1,370 @@
+#ifndef SPLINE_RENDERER_H
+#define SPLINE_RENDERER_H
+
+#include "../../SplineCore/Spline.h"
+#include "../../Shaders/Shader.h"
+
+// Draws a spline, along with its control points and custom orientations, for the editor and the follow modes.
+// The spline itself is GL-free, so all its drawing lives here.
+// Everything is drawn from a single vertex buffer, laid out as the spline lays out its points:
+//	[ curve | control points | orientation handles ]
+// When the spline changes, only the sections it rewrote and the control points it changed are written to the buffer again,
+//	so an edit costs as much as the sections it touched. All of it is only uploaded again once the spline lays out its points again.
+// The control polygon reuses the range of the control points, and the selected control point is highlighted
+//	by the shader from a range of vertices, instead of being drawn separately.
+// Only the sections of the curve inside the view frustum are drawn, in as many ranges as runs of consecutive visible sections.
+// Each visible section is drawn at the coarsest level of detail whose error stays under a pixel on screen,
+//	so the distant parts of long splines are drawn with far fewer vertices. The coarser levels are drawn from an index buffer
+//	that copies the indices of the levels of detail of the spline, to which only those appended since are uploaded.
+class SplineRenderer
+{
+public:
+	SplineRenderer() {}
+
+	~SplineRenderer()
+	{
+		Terminate();
+	}
+
+	// Creates the buffers and loads the shader. Needs a GL context.
+	void Init()
+	{
+		shader.Load("assets/Shaders/spline.vert", "assets/Shaders/spline.frag");
+
+		glGenVertexArrays(1, &vertexArrayObject);
+		glGenBuffers(1, &vertexBufferObject);
+		InitVAO(vertexArrayObject, vertexBufferObject);
+		glGenBuffers(1, &indexBufferObject);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferObject);
+
+		// a small buffer apart for the marker, which changes every frame
+		glGenVertexArrays(1, &markerVertexArrayObject);
+		glGenBuffers(1, &markerVertexBufferObject);
+		InitVAO(markerVertexArrayObject, markerVertexBufferObject);
+		glBufferData(GL_ARRAY_BUFFER, 2 * sizeof(glm::vec3), nullptr, GL_STREAM_DRAW);
+
+		glBindVertexArray(0);
+	}
+
+	template <typename Basis>
+	void Render(const Spline<Basis>& spline, const glm::mat4& viewProjectionMatrix)
+	{
+		if (&spline != (const void*)uploadedSpline)
+			Upload(spline);
+		else if (spline.Revision() != uploadedRevision)
+			Update(spline);
+
+		const int selectedControlPoint = spline.SelectedControlPointIndex();
+		GatherVisibleSections(spline, viewProjectionMatrix);
+		glBindVertexArray(vertexArrayObject);
+		UploadLevelsOfDetail(spline);
+
+		// use the shader
+		shader.Use();
+
+		// set uniforms
+		shader.SetUniform("modelViewProjection", viewProjectionMatrix);
+		shader.SetUniform("highlightColor", glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
+		shader.SetUniform("highlightRange", glm::ivec2(-1, -1));
+
+		// draw the visible sections of the spline curve, extended to the first and last control points if clamped
+		shader.SetUniform("color", glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+		DrawVisibleSections(GL_LINE_STRIP);
+		if (isExtended) {
+			glDrawArrays(GL_LINES, curveFirst, 2);
+			glDrawArrays(GL_LINES, curveFirst + curveCount - 2, 2);
+		}
+
+		// draw lines between control points
+		shader.SetUniform("color", glm::vec4(0.67f, 0.67f, 0.67f, 1.0f));
+		glDrawArrays(spline.IsCyclic() ? GL_LINE_LOOP : GL_LINE_STRIP, controlPointsFirst, controlPointsCount);
+
+		// draw custom orientations, highlighting the one of the selected control point
+		shader.SetUniform("color", glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		shader.SetUniform("highlightRange", glm::ivec2(handlesFirst + 2 * selectedControlPoint, handlesFirst + 2 * selectedControlPoint + 2));
+		glDrawArrays(GL_LINES, handlesFirst, 2 * controlPointsCount);
+
+		// draw the control points, highlighting the selected one
+		shader.SetUniform("highlightRange", glm::ivec2(controlPointsFirst + selectedControlPoint, controlPointsFirst + selectedControlPoint + 1));
+		glPointSize(10.0f);
+		glDrawArrays(GL_POINTS, controlPointsFirst, controlPointsCount);
+
+		if (spline.DrawDebugPoints()) {
+			// draw the points that are used to draw the spline
+			shader.SetUniform("color", glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+			shader.SetUniform("highlightRange", glm::ivec2(-1, -1));
+			glPointSize(3.0f);
+			DrawVisibleSections(GL_POINTS);
+		}
+
+		glBindVertexArray(0);
+	}
+
+	void ToggleLevelOfDetail()
+	{
+		isLevelOfDetailEnabled = !isLevelOfDetailEnabled;
+	}
+
+	// Draws a point with a line in the given direction, streamed as it changes every frame
+	void RenderMarker(const glm::vec3& point, const glm::vec3& direction, const glm::vec4& color, const glm::mat4& viewProjectionMatrix)
+	{
+		glm::vec3 vertices[2] = { point, point + direction };
+		glBindBuffer(GL_ARRAY_BUFFER, markerVertexBufferObject);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+
+		shader.Use();
+		shader.SetUniform("modelViewProjection", viewProjectionMatrix);
+		shader.SetUniform("highlightRange", glm::ivec2(-1, -1));
+		shader.SetUniform("color", color);
+
+		glBindVertexArray(markerVertexArrayObject);
+		glPointSize(10.0f);
+		glDrawArrays(GL_POINTS, 0, 1);
+		glDrawArrays(GL_LINES, 0, 2);
+		glBindVertexArray(0);
+	}
+
+protected:
+
+	void InitVAO(GLuint vao, GLuint vbo)
+	{
+		glBindVertexArray(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+		// The 0 attribute(pos) has 3 elements (x,y,z) of type GL_FLOAT
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+		glEnableVertexAttribArray(0);
+	}
+
+	// Finds the ranges of vertices of the sections inside the frustum at level of detail 0, merging those of consecutive sections,
+	//	and the ranges of indices of those at coarser levels, each drawn on its own from the first point of its section.
+	// Consecutive sections share their end points, so a merged range is drawn as a single line strip.
+	// The levels of all visible sections are selected first, as simplifying those that changed may compact the indices of the others.
+	template <typename Basis>
+	void GatherVisibleSections(const Spline<Basis>& spline, const glm::mat4& viewProjectionMatrix)
+	{
+		const std::vector<unsigned int>& sectionOffsets = spline.GetSectionOffsets();
+		spline.GetVisibleSections(Frustum(viewProjectionMatrix), visibleSections);
+
+		// The pixels covered by a world unit at a distance of 1 along the view direction, from the rows of the matrix
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glm::mat4 rows = glm::transpose(viewProjectionMatrix);
+		float pixelsPerUnit = std::max(glm::length(glm::vec3(rows[0])) * viewport[2], glm::length(glm::vec3(rows[1])) * viewport[3]) * 0.5f;
+
+		visibleLevels.resize(visibleSections.size());
+		for (unsigned int k = 0; k < visibleSections.size(); k++)
+			visibleLevels[k] = isLevelOfDetailEnabled ? SelectLevelOfDetail(spline, visibleSections[k], rows[3], pixelsPerUnit) : 0;
+
+		visibleFirsts.clear();
+		visibleCounts.clear();
+		levelOfDetailCounts.clear();
+		levelOfDetailOffsets.clear();
+		levelOfDetailBaseVertices.clear();
+		for (unsigned int k = 0; k < visibleSections.size(); k++) {
+			unsigned int i = visibleSections[k];
+			if (visibleLevels[k] > 0) {
+				unsigned int first, count;
+				spline.GetSectionLevelOfDetail(i, visibleLevels[k], first, count);
+				levelOfDetailCounts.push_back(count);
+				levelOfDetailOffsets.push_back((const void*)(first * sizeof(unsigned int)));
+				levelOfDetailBaseVertices.push_back(splinePointsFirst + sectionOffsets[i]);
+			}
+			else if (k > 0 && visibleSections[k - 1] == i - 1 && visibleLevels[k - 1] == 0)
+				visibleCounts.back() += sectionOffsets[i + 1] - sectionOffsets[i];
+			else {
+				visibleFirsts.push_back(splinePointsFirst + sectionOffsets[i]);
+				visibleCounts.push_back(sectionOffsets[i + 1] - sectionOffsets[i]);
+			}
+		}
+	}
+
+	// Draws the ranges of the visible sections found by GatherVisibleSections
+	void DrawVisibleSections(GLenum mode)
+	{
+		glMultiDrawArrays(mode, visibleFirsts.data(), visibleCounts.data(), (GLsizei)visibleFirsts.size());
+		glMultiDrawElementsBaseVertex(mode, levelOfDetailCounts.data(), GL_UNSIGNED_INT, levelOfDetailOffsets.data(),
+			(GLsizei)levelOfDetailCounts.size(), levelOfDetailBaseVertices.data());
+	}
+
+	// The coarsest level of detail of the i-th section whose error is under a pixel, at the nearest depth of its bounding box
+	template <typename Basis>
+	int SelectLevelOfDetail(const Spline<Basis>& spline, unsigned int i, const glm::vec4& depthRow, float pixelsPerUnit) const
+	{
+		glm::vec3 center, extent;
+		spline.GetSectionBounds(i, center, extent);
+		float depth = glm::dot(glm::vec3(depthRow), center) + depthRow.w - glm::dot(glm::abs(glm::vec3(depthRow)), extent);
+		if (depth <= 0.0f)
+			return 0;
+
+		float maxError = depth / pixelsPerUnit;
+		for (int level = Spline<Basis>::LevelOfDetailCount - 1; level > 0; level--)
+			if (spline.GetSectionLevelOfDetailError(i, level) <= maxError)
+				return level;
+		return 0;
+	}
+
+	// Rebuilds all the vertices of the spline and uploads them, growing the buffer only when they do not fit,
+	//	and leaves all the indices of its levels of detail to be uploaded again
+	template <typename Basis>
+	void Upload(const Spline<Basis>& spline)
+	{
+		const std::vector<glm::vec3>& controlPoints = spline.ControlPoints();
+		const std::vector<glm::vec3>& orientations = spline.Orientations();
+		const std::vector<glm::vec3>& splinePoints = spline.GetSplinePoints();
+		isExtended = !spline.IsCyclic() && !spline.IsInterpolating();
+
+		vertices.clear();
+		curveFirst = 0;
+		if (isExtended)
+			vertices.push_back(controlPoints.front());
+		splinePointsFirst = vertices.size();
+		vertices.insert(vertices.end(), splinePoints.begin(), splinePoints.end());
+		if (isExtended)
+			vertices.push_back(controlPoints.back());
+		curveCount = vertices.size();
+
+		controlPointsFirst = vertices.size();
+		controlPointsCount = controlPoints.size();
+		vertices.insert(vertices.end(), controlPoints.begin(), controlPoints.end());
+
+		handlesFirst = vertices.size();
+		for (unsigned int i = 0; i < controlPoints.size(); i++) {
+			vertices.push_back(controlPoints[i]);
+			vertices.push_back(controlPoints[i] + orientations[i]);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObject);
+		if (vertices.size() > bufferCapacity) {
+			bufferCapacity = vertices.size() + vertices.size() / 2;
+			glBufferData(GL_ARRAY_BUFFER, bufferCapacity * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
+		}
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(glm::vec3), vertices.data());
+
+		uploadedSpline = &spline;
+		uploadedRevision = spline.Revision();
+		uploadedLevelOfDetailIndices = 0;
+	}
+
+	// Writes the points of the sections the spline rewrote since the last upload over their ranges of the vertex buffer,
+	//	which are as large as the room of each section, along with the control points and handles it changed since.
+	// Uploads all of it again if the spline laid out its points again since, as the ranges moved.
+	template <typename Basis>
+	void Update(const Spline<Basis>& spline)
+	{
+		if (!spline.GetChangesSince(uploadedRevision, changedSections, changedControlPoints)) {
+			Upload(spline);
+			return;
+		}
+
+		const std::vector<glm::vec3>& controlPoints = spline.ControlPoints();
+		const std::vector<glm::vec3>& orientations = spline.Orientations();
+		const std::vector<glm::vec3>& splinePoints = spline.GetSplinePoints();
+		const std::vector<unsigned int>& sectionOffsets = spline.GetSectionOffsets();
+
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObject);
+		for (unsigned int i : changedSections) {
+			unsigned int first = sectionOffsets[i], count = sectionOffsets[i + 1] - first;
+			glBufferSubData(GL_ARRAY_BUFFER, (splinePointsFirst + first) * sizeof(glm::vec3), count * sizeof(glm::vec3), &splinePoints[first]);
+		}
+		for (unsigned int i : changedControlPoints) {
+			glm::vec3 handle[2] = { controlPoints[i], controlPoints[i] + orientations[i] };
+			glBufferSubData(GL_ARRAY_BUFFER, (controlPointsFirst + i) * sizeof(glm::vec3), sizeof(glm::vec3), &controlPoints[i]);
+			glBufferSubData(GL_ARRAY_BUFFER, (handlesFirst + 2 * i) * sizeof(glm::vec3), sizeof(handle), handle);
+			if (isExtended && i == 0)
+				glBufferSubData(GL_ARRAY_BUFFER, curveFirst * sizeof(glm::vec3), sizeof(glm::vec3), &controlPoints[i]);
+			if (isExtended && i == controlPoints.size() - 1)
+				glBufferSubData(GL_ARRAY_BUFFER, (curveFirst + curveCount - 1) * sizeof(glm::vec3), sizeof(glm::vec3), &controlPoints[i]);
+		}
+
+		uploadedRevision = spline.Revision();
+	}
+
+	// Uploads the indices of the levels of detail the spline appended since the last upload, or all of them if it compacted them since,
+	//	growing the index buffer only when they do not fit. Needs the vertex array bound, which the index buffer belongs to.
+	template <typename Basis>
+	void UploadLevelsOfDetail(const Spline<Basis>& spline)
+	{
+		const std::vector<unsigned int>& indices = spline.GetLevelOfDetailIndices();
+		size_t first = uploadedLevelOfDetailIndices;
+		if (spline.LevelOfDetailCompactions() != uploadedLevelOfDetailCompactions || first > indices.size())
+			first = 0;
+		if (first == indices.size())
+			return;
+
+		if (indices.size() > indexBufferCapacity) {
+			indexBufferCapacity = indices.size() + indices.size() / 2;
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBufferCapacity * sizeof(unsigned int), nullptr, GL_DYNAMIC_DRAW);
+			first = 0;
+		}
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first * sizeof(unsigned int), (indices.size() - first) * sizeof(unsigned int), &indices[first]);
+
+		uploadedLevelOfDetailIndices = indices.size();
+		uploadedLevelOfDetailCompactions = spline.LevelOfDetailCompactions();
+	}
+
+	void Terminate()
+	{
+		glDeleteVertexArrays(1, &vertexArrayObject);
+		glDeleteBuffers(1, &vertexBufferObject);
+		glDeleteBuffers(1, &indexBufferObject);
+		glDeleteVertexArrays(1, &markerVertexArrayObject);
+		glDeleteBuffers(1, &markerVertexBufferObject);
+	}
+
+private:
+
+	// vbo, vao
+	GLuint vertexBufferObject = 0;
+	GLuint vertexArrayObject = 0;
+	GLuint indexBufferObject = 0;
+	GLuint markerVertexBufferObject = 0;
+	GLuint markerVertexArrayObject = 0;
+
+	// the number of vertices the vertex buffer can hold, and of indices the index buffer can
+	size_t bufferCapacity = 0;
+	size_t indexBufferCapacity = 0;
+
+	// the vertices, kept to reuse their memory
+	std::vector<glm::vec3> vertices;
+
+	// the spline in the vertex buffer, and its revision when it was uploaded
+	const void* uploadedSpline = nullptr;
+	unsigned int uploadedRevision = 0;
+
+	// the sections and control points the spline changed since the last upload, kept to reuse their memory
+	std::vector<unsigned int> changedSections;
+	std::vector<unsigned int> changedControlPoints;
+
+	// the number of indices of the levels of detail of the spline in the index buffer, and the number of times it had compacted them then
+	size_t uploadedLevelOfDetailIndices = 0;
+	unsigned int uploadedLevelOfDetailCompactions = 0;
+
+	// the ranges of the vertex buffer
+	GLint curveFirst = 0, curveCount = 0;
+	GLint splinePointsFirst = 0;
+	GLint controlPointsFirst = 0, controlPointsCount = 0;
+	GLint handlesFirst = 0;
+
+	// whether the sections are drawn at their level of detail, or always with all their points
+	bool isLevelOfDetailEnabled = true;
+
+	// whether the curve is extended to the first and last control points, by a line before and after its points
+	bool isExtended = false;
+
+	// the sections inside the view frustum in the last frame, their levels of detail, and the ranges of the vertex buffer of those at level 0
+	std::vector<unsigned int> visibleSections;
+	std::vector<int> visibleLevels;
+	std::vector<GLint> visibleFirsts;
+	std::vector<GLsizei> visibleCounts;
+
+	// the ranges of the index buffer of the visible sections at coarser levels, as byte offsets, and the first vertex of each of their sections
+	std::vector<GLsizei> levelOfDetailCounts;
+	std::vector<const void*> levelOfDetailOffsets;
+	std::vector<GLint> levelOfDetailBaseVertices;
+
+	// shader
+	Shader shader;
+};
+
+#endif // !SPLINE_RENDERER_H
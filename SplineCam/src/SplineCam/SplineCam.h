@@ -10,14 +10,18 @@
 #include "Camera/FollowSplineCamera.h"
 #include "Camera/FPSCamera.h"
 #include "Camera/FreeCamera.h"
-#include "Spline/Spline.h"
+#include "../SplineCore/Frustum.h"
+#include "../SplineCore/Spline.h"
+#include "Spline/SplineRenderer.h"
 #include "Spline/SplineManager.h"
 #include "States/FreeCamState.h"
 #include "States/SplineEditorState.h"
 #include "States/FollowSplineState.h"
 
 #include <cassert>
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 class SplineCam : public InputListener
 {
@@ -29,6 +33,29 @@ class SplineCam : public InputListener
 		FOLLOW_SPLINE
 	};
 
+	// a cube of the scene
+	struct Cube
+	{
+		bool enabled = false;
+
+		glm::vec3 pos = glm::vec3(0.0f, 0.0f, 0.0f);
+		glm::vec3 rotation = glm::vec3(0.0f, 0.0f, 0.0f);
+		glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
+		glm::vec4 color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+
+		// the cached transform, from pos, rotation and scale, and the half extents of its world-space bounding box
+		glm::mat4 model;
+		glm::vec3 extent;
+		bool isModelDirty = true;
+	};
+
+	// the data of each enabled cube in the instance buffer
+	struct CubeInstance
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+	};
+
 public:
 	SplineCam() 
 	{
@@ -69,8 +96,18 @@ public:
 		}
 	};
 
+	// The number of cubes drawn, and left out by the frustum culling, in the last frame
+	size_t VisibleCubeCount() const { return visibleCubeCount; }
+	size_t CulledCubeCount() const { return culledCubeCount; }
+
 	void OnKeyReleased(int key) override { };
-	void OnMouseButtonPressed(int button, double x, double y) override { };
+	void OnMouseButtonPressed(int button, double x, double y) override 
+	{
+		if (state)
+		{
+			state->OnMouseButtonPressed(button, x, y);
+		}
+	}
 	void OnMouseButtonReleased(int button, double x, double y) override { };
 	void OnMouseScroll(double xoffset, double yoffset) override { };
 	
@@ -107,14 +144,20 @@ protected:
 		// init the vertex buffer object
 		InitVBO();
 
-		// init the indeces buffer object
-		InitIBO();
-
 		// init the vertex array object
 		InitVAO();
 
+		// init the indeces buffer object, while the vertexArrayObject is bound so it keeps track of it
+		InitIBO();
+
+		// init the instance buffer object, with the model matrix and color of each cube
+		InitInstanceBO();
+
+		// do not use the vertexArrayObject anymore
+		glBindVertexArray(0);
+
 		// load shader
-		shader.Load("assets/Shaders/basic.vert", "assets/Shaders/basic.frag");
+		shader.Load("assets/Shaders/cube.vert", "assets/Shaders/cube.frag");
 
 		// init cubes
 		InitCubes();
@@ -156,8 +199,29 @@ protected:
 		glEnableVertexAttribArray(0);
 	}
 
+	void InitInstanceBO()
+	{
+		// create one buffer in the GPU for the per-instance data, filled in when the visible cubes change
+		glGenBuffers(1, &instanceBufferObject);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBufferObject);
+
+		// The 1 to 4 attributes are the columns of the model matrix, and the 5 attribute is the color.
+		// They advance once per instance instead of once per vertex
+		for (int column = 0; column < 4; column++)
+		{
+			glVertexAttribPointer(1 + column, 4, GL_FLOAT, GL_FALSE, sizeof(CubeInstance), (void*)(offsetof(CubeInstance, model) + column * sizeof(glm::vec4)));
+			glEnableVertexAttribArray(1 + column);
+			glVertexAttribDivisor(1 + column, 1);
+		}
+		glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(CubeInstance), (void*)offsetof(CubeInstance, color));
+		glEnableVertexAttribArray(5);
+		glVertexAttribDivisor(5, 1);
+	}
+
 	void InitCubes()
 	{
+		cubes.resize(14);
+
 		// floor
 		cubes[0].pos = glm::vec3(0.0f, 0.0f, 10.0f);
 		cubes[0].scale = glm::vec3(40.0f, 0.0001f, 40.f);
@@ -242,6 +306,99 @@ protected:
 		cubes[13].scale = glm::vec3(5.0f, 1.0f, 0.25f);
 		cubes[13].color = glm::vec4(0.0f, 0.5f, 0.0f, 1.0f);
 		cubes[13].enabled = true;
+
+		areCubesDirty = true;
+	}
+
+	// Replaces the i-th cube. Its model matrix is recomputed on the next draw
+	void SetCube(unsigned int i, const Cube& cube)
+	{
+		if (i >= cubes.size())
+		{
+			cubes.resize(i + 1);
+		}
+
+		cubes[i] = cube;
+		cubes[i].isModelDirty = true;
+		areCubesDirty = true;
+	}
+
+	// Recomputes the model matrices and bounding boxes of the changed cubes, and gathers those of the enabled ones
+	void UpdateCubeInstances()
+	{
+		areCubesDirty = false;
+		isInstanceBufferStale = true;
+
+		cubeInstances.clear();
+		for (std::vector<float>& bounds : cubeBounds)
+		{
+			bounds.clear();
+		}
+
+		for (Cube& cube : cubes)
+		{
+			if (cube.isModelDirty)
+			{
+				glm::mat4 model;
+				cube.model = glm::translate(model, cube.pos) 
+						   * glm::rotate(model, cube.rotation.z, glm::vec3(0.0f, 0.0f, 1.0f)) 
+						   * glm::rotate(model, cube.rotation.y, glm::vec3(0.0f, 1.0f, 0.0f)) 
+						   * glm::rotate(model, cube.rotation.x, glm::vec3(1.0f, 0.0f, 0.0f))
+						   * glm::scale(model, cube.scale);
+
+				// the half extents of the box around the unit cube once transformed, along each world axis
+				for (int axis = 0; axis < 3; axis++)
+				{
+					cube.extent[axis] = fabsf(cube.model[0][axis]) + fabsf(cube.model[1][axis]) + fabsf(cube.model[2][axis]);
+				}
+				cube.isModelDirty = false;
+			}
+
+			if (cube.enabled)
+			{
+				cubeInstances.push_back({ cube.model, cube.color });
+				for (int axis = 0; axis < 3; axis++)
+				{
+					cubeBounds[axis].push_back(cube.model[3][axis]);
+					cubeBounds[3 + axis].push_back(cube.extent[axis]);
+				}
+			}
+		}
+	}
+
+	// Gathers the cubes inside the view frustum, and uploads them to the instance buffer if they are not those already in it
+	void CullCubes(const glm::mat4& viewProjection)
+	{
+		Frustum frustum(viewProjection);
+
+		visibleCubes.resize(cubeInstances.size());
+		visibleCubeCount = frustum.CullBoxes(cubeBounds[0].data(), cubeBounds[1].data(), cubeBounds[2].data(),
+			cubeBounds[3].data(), cubeBounds[4].data(), cubeBounds[5].data(), cubeInstances.size(), visibleCubes.data());
+		culledCubeCount = cubeInstances.size() - visibleCubeCount;
+
+		// while the camera moves without the set of visible cubes changing, the buffer is left as it is
+		if (!isInstanceBufferStale && uploadedVisibleCubes.size() == visibleCubeCount
+			&& std::equal(uploadedVisibleCubes.begin(), uploadedVisibleCubes.end(), visibleCubes.begin()))
+		{
+			return;
+		}
+		isInstanceBufferStale = false;
+		uploadedVisibleCubes.assign(visibleCubes.begin(), visibleCubes.begin() + visibleCubeCount);
+
+		visibleCubeInstances.clear();
+		for (size_t i = 0; i < visibleCubeCount; i++)
+		{
+			visibleCubeInstances.push_back(cubeInstances[visibleCubes[i]]);
+		}
+
+		// the buffer is allocated for all the enabled cubes, so that only its start is rewritten as the visible ones change
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBufferObject);
+		if (instanceBufferCapacity < cubeInstances.size())
+		{
+			instanceBufferCapacity = cubeInstances.size();
+			glBufferData(GL_ARRAY_BUFFER, instanceBufferCapacity * sizeof(CubeInstance), nullptr, GL_DYNAMIC_DRAW);
+		}
+		glBufferSubData(GL_ARRAY_BUFFER, 0, visibleCubeInstances.size() * sizeof(CubeInstance), visibleCubeInstances.data());
 	}
 
 	void SetMode(Mode newMode)
@@ -295,31 +452,25 @@ protected:
 			return;
 		}
 
+		if (areCubesDirty)
+		{
+			UpdateCubeInstances();
+		}
+
 		const glm::mat4& viewProjection = camera->ViewProjectionMatrix();
 
+		// only draw the cubes the camera can see
+		CullCubes(viewProjection);
+
 		// use the shader
 		shader.Use();	
+		shader.SetUniform("viewProjection", viewProjection);
 
 		// tell the vertexArrayObject to be used
 		glBindVertexArray(vertexArrayObject);
 
-		glm::mat4 model;
-		for (int i = 0; i < NUM_CUBES; i++)
-		{
-			Cube cube = cubes[i];
-			if (cube.enabled)
-			{
-				model = glm::mat4();
-				model = glm::translate(model, cube.pos) 
-					  * glm::rotate(model, cube.rotation.z, glm::vec3(0.0f, 0.0f, 1.0f)) 
-					  * glm::rotate(model, cube.rotation.y, glm::vec3(0.0f, 1.0f, 0.0f)) 
-					  * glm::rotate(model, cube.rotation.x, glm::vec3(1.0f, 0.0f, 0.0f))
-					  * glm::scale(model, cube.scale);
-				shader.SetUniform("modelViewProjection", viewProjection * model);
-				shader.SetUniform("color", cube.color);
-				glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)indices); // tell to draw cube by using the IBO
-			}
-		}
+		// draw all the visible cubes at once, each instance with its own model matrix and color
+		glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr, (GLsizei)visibleCubeInstances.size());
 
 		// do not use the vertexArrayObject anymore
 		glBindVertexArray(0);
@@ -330,6 +481,7 @@ protected:
 		glDeleteVertexArrays(1, &vertexArrayObject);
 		glDeleteBuffers(1, &vertexBufferObject);
 		glDeleteBuffers(1, &indexBufferObject);
+		glDeleteBuffers(1, &instanceBufferObject);
 	}
 
 	void ToggleWireframeMode()
@@ -367,27 +519,35 @@ private:
 		7, 2, 6,    7, 3, 2		// bottom face	
 	};
 	
-	// vbo, vao, ibo 
+	// vbo, vao, ibo, and the buffer of the per-instance data
 	GLuint vertexBufferObject;
 	GLuint indexBufferObject;
 	GLuint vertexArrayObject; 
+	GLuint instanceBufferObject;
 	
 	// shader
 	Shader shader;
 
-	// cubes
-	struct Cube
-	{
-		bool enabled = false;
+	// cubes, and the data of the enabled ones
+	std::vector<Cube> cubes;
+	std::vector<CubeInstance> cubeInstances;
 
-		glm::vec3 pos = glm::vec3(0.0f, 0.0f, 0.0f);
-		glm::vec3 rotation = glm::vec3(0.0f, 0.0f, 0.0f);
-		glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
-		glm::vec4 color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-	};
+	// the bounding boxes of the enabled cubes, as the x, y, z of their centers and then of their half extents
+	std::vector<float> cubeBounds[6];
+
+	// the enabled cubes inside the view frustum in the last frame, and those in the instance buffer, with their data as uploaded to it
+	std::vector<unsigned int> visibleCubes;
+	std::vector<unsigned int> uploadedVisibleCubes;
+	std::vector<CubeInstance> visibleCubeInstances;
+	size_t visibleCubeCount = 0;
+	size_t culledCubeCount = 0;
+
+	// the number of instances the instance buffer has room for, and whether the data of the cubes changed since it was uploaded
+	size_t instanceBufferCapacity = 0;
+	bool isInstanceBufferStale = true;
 
-	static const int NUM_CUBES = 1024;
-	Cube cubes[NUM_CUBES];
+	// whether the cubes changed since their instances were gathered
+	bool areCubesDirty = true;
 
 	Mode mode = Mode::NONE;
 	std::unique_ptr<SplineCamState> state;
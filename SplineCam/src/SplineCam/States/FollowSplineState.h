@@ -2,6 +2,7 @@
 #define FOLLOW_SPLINE_STATE_H
 
 #include "SplineCamState.h"
+#include "../Spline/SplineRenderer.h"
 
 class FollowSplineState : public SplineCamState
 {
@@ -15,8 +16,10 @@ public:
 		spline = SplineManager::Get()->GetSpline(0);
 
 		camera.Init(spline, 45.0f, 1024.0f / 768.0f, 0.1f, 1000000.0f);
+		splineRenderer.Init();
 
 		doRenderSpline = false;
+		isFollowingTrack = false;
 	}
 
 	void Stop() override
@@ -40,6 +43,18 @@ public:
 				spline->ToggleDebugPoints();
 			break;
 
+		case GLFW_KEY_F5:
+			splineRenderer.ToggleLevelOfDetail();
+			break;
+
+		case GLFW_KEY_F7:
+			isFollowingTrack = !isFollowingTrack;
+			if (isFollowingTrack)
+				StartTrack();
+			else
+				camera.Init(spline, 45.0f, 1024.0f / 768.0f, 0.1f, 1000000.0f);
+			break;
+
 		case GLFW_KEY_SPACE:
 			camera.isPaused = !camera.isPaused;
 			break;
@@ -55,17 +70,41 @@ public:
 
 	void Render(Shader& shader) override
 	{
-		if (doRenderSpline)
-			spline->Render(camera.ViewProjectionMatrix(), shader);
+		if (doRenderSpline && !isFollowingTrack)
+			splineRenderer.Render(*spline, camera.ViewProjectionMatrix());
 	}
 
 private:
 
+	// Follows an endless track, generated as it is streamed: it winds randomly over gentle hills, a control point every 10 units
+	void StartTrack()
+	{
+		unsigned int seed = 12345;
+		float heading = 0.0f, turn = 0.0f;
+		glm::vec3 position = spline->GetPoint(0.0f);
+		trackSource.Init([=](glm::vec3& outControlPoint, glm::vec3&) mutable {
+			seed = seed * 1664525u + 1013904223u;
+			turn = glm::clamp(turn + ((seed >> 8) / 16777216.0f - 0.5f) * 0.2f, -0.3f, 0.3f);
+			heading += turn;
+			position += 10.0f * glm::vec3(sinf(heading), 0.0f, cosf(heading));
+			outControlPoint = glm::vec3(position.x, 5.0f * sinf(position.x * 0.01f) * cosf(position.z * 0.013f), position.z);
+			return true;
+		});
+		track.Init(&trackSource);
+		camera.Init(&track, 45.0f, 1024.0f / 768.0f, 0.1f, 1000000.0f);
+	}
+
 	FollowSplineCamera camera;
 
-	Spline* spline;
+	Spline<>* spline;
+	SplineRenderer splineRenderer;
 
 	bool doRenderSpline;
+
+	// The endless track, streamed in chunks as the camera moves along it, and whether it is followed instead of the spline
+	SplineGeneratorChunkSource trackSource;
+	StreamingSpline<> track;
+	bool isFollowingTrack;
 };
 
 #endif // !FOLLOW_SPLINE_STATE_H
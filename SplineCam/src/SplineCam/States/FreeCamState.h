@@ -2,6 +2,8 @@
 #define FREE_CAM_STATE_H
 
 #include "SplineCamState.h"
+#include "../Spline/SplineManager.h"
+#include "../../SplineCore/SplineFitter.h"
 
 class FreeCamState : public SplineCamState
 {
@@ -29,11 +31,32 @@ public:
 
 	void OnKeyPressed(int key) override
 	{
+		switch (key)
+		{
+
+		case GLFW_KEY_R:
+			if (isRecording)
+				StopRecording();
+			else {
+				recordedTimes.clear();
+				recordedPositions.clear();
+				recordingTime = 0.0;
+				isRecording = true;
+				printf("Recording the camera path\n");
+			}
+			break;
+		}
 	};
 
 	void Update(float deltaTime) override
 	{
 		camera.Update(deltaTime);
+
+		if (isRecording) {
+			recordingTime += deltaTime;
+			recordedTimes.push_back(recordingTime);
+			recordedPositions.push_back(camera.GetPosition());
+		}
 	}
 
 	void Render(Shader& shader) override
@@ -42,9 +65,30 @@ public:
 
 private:
 
+	// Fits the spline to the recorded path, within a tenth of a unit, replacing its control points
+	void StopRecording()
+	{
+		isRecording = false;
+		std::vector<glm::vec3> controlPoints;
+		float error;
+		SplineFitter::FitWithinTolerance(recordedTimes.data(), recordedPositions.data(), recordedPositions.size(), 0.1f, controlPoints, &error);
+		if (controlPoints.size() < 2) {
+			printf("The recorded path is too short to fit the spline to\n");
+			return;
+		}
+		SplineManager::Get()->GetSpline(0)->Init(controlPoints);
+		printf("Fitted %zu control points to %zu recorded positions, within %f\n", controlPoints.size(), recordedPositions.size(), error);
+	}
+
 	// camera
 	//FPSCamera camera;
 	FreeCamera camera;
+
+	// The positions of the camera recorded at every frame, and the time at each of them
+	bool isRecording = false;
+	double recordingTime = 0.0;
+	std::vector<double> recordedTimes;
+	std::vector<glm::vec3> recordedPositions;
 };
 
 #endif // !FREE_CAM_STATE_H
@@ -3,6 +3,7 @@
 
 #include "SplineCamState.h"
 #include "../Spline/SplineManager.h"
+#include "../Spline/SplineRenderer.h"
 
 class SplineEditorState : public SplineCamState
 {
@@ -17,6 +18,7 @@ public:
 
 		// init spline
 		spline = SplineManager::Get()->GetSpline(0);
+		splineRenderer.Init();
 
 		isPaused = false;
 	}
@@ -69,9 +71,43 @@ public:
 			spline->ToggleCyclicOrClamped();
 			break;
 
+		case GLFW_KEY_F5:
+			splineRenderer.ToggleLevelOfDetail();
+			break;
+
+		case GLFW_KEY_F6:
+			SplineManager::Get()->SaveSpline(0);
+			break;
+
 		}
 	};
 
+	// Selects the control point under the cursor, or if there is none, moves the animated point to the curve under it
+	void OnMouseButtonPressed(int button, double x, double y) override
+	{
+		if (button != GLFW_MOUSE_BUTTON_LEFT)
+			return;
+
+		// the cursor is in window coordinates, which differ from the pixels of the framebuffer on high-DPI screens
+		int width, height;
+		glfwGetWindowSize(glfwGetCurrentContext(), &width, &height);
+		if (width <= 0 || height <= 0)
+			return;
+		glm::vec3 origin, direction, offsetDirection;
+		camera.GetRay(x, y, width, height, origin, direction);
+		camera.GetRay(x + pickRadius, y, width, height, origin, offsetDirection);
+
+		// the slope of the cone around the ray that covers the pick radius on screen
+		float slope = glm::length(glm::cross(direction, offsetDirection)) / glm::dot(direction, offsetDirection);
+
+		int controlPoint = spline->PickControlPoint(origin, direction, slope);
+		float t;
+		if (controlPoint >= 0)
+			spline->SelectControlPoint(controlPoint);
+		else if (spline->PickCurve(origin, direction, slope, t))
+			animationFrame = t;
+	}
+
 	void Update(float deltaTime) override
 	{
 		camera.Update(deltaTime);
@@ -79,10 +115,13 @@ public:
 
 		if (!isPaused || Input::isKeyPressed(GLFW_KEY_Z) || Input::isKeyPressed(GLFW_KEY_X)) {
 			int step = Input::isKeyPressed(GLFW_KEY_Z) ? -1 : !isPaused + Input::isKeyPressed(GLFW_KEY_X);
-			animationFrame += 10.0f * step * deltaTime * (1/spline->GetLength());
-			if (animationFrame < 0)
-				animationFrame += (int)animationFrame + 1;
-			animationFrame = fmodf(animationFrame, 1);
+
+			// advance at constant speed along the arc length, looping at both ends
+			float length = spline->GetLength();
+			float distance = fmodf(spline->GetDistanceAtParameter(animationFrame) + 10.0f * step * deltaTime, length);
+			if (distance < 0)
+				distance += length;
+			animationFrame = spline->GetParameterAtDistance(distance);
 		}
 
 		if (Input::isKeyPressed(GLFW_KEY_F)) {
@@ -97,8 +136,8 @@ public:
 
 	void Render(Shader& shader) override
 	{
-		spline->Render(camera.ViewProjectionMatrix(), shader);
-		DrawAnimatedPoint(shader);
+		splineRenderer.Render(*spline, camera.ViewProjectionMatrix());
+		DrawAnimatedPoint();
 	}
 
 protected:
@@ -131,26 +170,12 @@ protected:
 		}
 	}
 
-	void DrawAnimatedPoint(Shader& shader)
+	void DrawAnimatedPoint()
 	{
-		// use the shader
-		shader.Use();
-
-		// set uniforms
-		shader.SetUniform("modelViewProjection", camera.ViewProjectionMatrix());
-		shader.SetUniform("color", glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
-
-		// draw the control points
+		// draw the animated point with its tangent
 		glm::vec3 point = spline->GetPoint(animationFrame);
 		glm::vec3 tangent = spline->GetTangent(animationFrame);
-		glPointSize(10.0f);
-		glBegin(GL_POINTS);
-		glVertex3f(point.x, point.y, point.z);
-		glEnd();
-		glBegin(GL_LINES);
-		glVertex3f(point.x, point.y, point.z);
-		glVertex3f(point.x + tangent.x, point.y + tangent.y, point.z + tangent.z);
-		glEnd();
+		splineRenderer.RenderMarker(point, tangent, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), camera.ViewProjectionMatrix());
 	}
 
 private:
@@ -159,11 +184,15 @@ private:
 	float animationFrame = 0.0f;
 	bool isPaused;
 
+	// how far from the cursor, in window coordinates, a control point or the curve can be picked
+	const double pickRadius = 8.0;
+
 	// camera
 	FreeCamera camera;
 
 	// spline
-	Spline* spline = nullptr;
+	Spline<>* spline = nullptr;
+	SplineRenderer splineRenderer;
 };
 
 #endif // !SPLINE_EDITOR_STATE
@@ -0,0 +1,113 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+#include <math.h>
+#include "glm/glm.hpp"
+
+#if defined(__AVX__)
+#define FRUSTUM_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_SSE
+#include <emmintrin.h>
+#endif
+
+// The view frustum of a camera, as the 6 planes bounding what its view projection matrix keeps on screen.
+// Axis-aligned boxes are tested against it in batches, given as a structure of arrays of their centers and half extents.
+// The AVX or SSE test is picked at compile time depending on the target instruction set, with a scalar fallback.
+class Frustum
+{
+public:
+
+	// Extracts the planes from the rows of the view projection matrix, facing inwards
+	Frustum(const glm::mat4& viewProjection)
+	{
+		glm::vec4 rows[4];
+		for (int i = 0; i < 4; i++)
+			rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+		planes[0] = rows[3] + rows[0]; // left
+		planes[1] = rows[3] - rows[0]; // right
+		planes[2] = rows[3] + rows[1]; // bottom
+		planes[3] = rows[3] - rows[1]; // top
+		planes[4] = rows[3] + rows[2]; // near
+		planes[5] = rows[3] - rows[2]; // far
+
+		for (int i = 0; i < 6; i++)
+			planes[i] /= glm::length(glm::vec3(planes[i]));
+	}
+
+	// Whether the box is at least partially inside the frustum (or close to a corner of it, as the test is conservative)
+	bool IsBoxVisible(const glm::vec3& center, const glm::vec3& extent) const
+	{
+		for (int i = 0; i < 6; i++) {
+			const glm::vec4& p = planes[i];
+			if (p.x * center.x + p.y * center.y + p.z * center.z + p.w + fabsf(p.x) * extent.x + fabsf(p.y) * extent.y + fabsf(p.z) * extent.z < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+	// Writes the indices of the visible boxes, in order, to outVisible, which must hold count indices.
+	// Returns the number of visible boxes.
+	size_t CullBoxes(const float* centerX, const float* centerY, const float* centerZ,
+		const float* extentX, const float* extentY, const float* extentZ, size_t count, unsigned int* outVisible) const
+	{
+		size_t visible = 0, k = 0;
+#if defined(FRUSTUM_AVX)
+		for (; k + 8 <= count; k += 8) {
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			__m256 cx = _mm256_loadu_ps(centerX + k), cy = _mm256_loadu_ps(centerY + k), cz = _mm256_loadu_ps(centerZ + k);
+			__m256 ex = _mm256_loadu_ps(extentX + k), ey = _mm256_loadu_ps(extentY + k), ez = _mm256_loadu_ps(extentZ + k);
+			for (int i = 0; i < 6; i++) {
+				const glm::vec4& p = planes[i];
+				__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.x), cx), _mm256_mul_ps(_mm256_set1_ps(p.y), cy)),
+					_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.z), cz), _mm256_set1_ps(p.w)));
+				__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(fabsf(p.x)), ex), _mm256_mul_ps(_mm256_set1_ps(fabsf(p.y)), ey)),
+					_mm256_mul_ps(_mm256_set1_ps(fabsf(p.z)), ez));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+			}
+			visible = AppendVisible(_mm256_movemask_ps(inside), k, outVisible, visible);
+		}
+#endif
+#if defined(FRUSTUM_AVX) || defined(FRUSTUM_SSE)
+		for (; k + 4 <= count; k += 4) {
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			__m128 cx = _mm_loadu_ps(centerX + k), cy = _mm_loadu_ps(centerY + k), cz = _mm_loadu_ps(centerZ + k);
+			__m128 ex = _mm_loadu_ps(extentX + k), ey = _mm_loadu_ps(extentY + k), ez = _mm_loadu_ps(extentZ + k);
+			for (int i = 0; i < 6; i++) {
+				const glm::vec4& p = planes[i];
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), cx), _mm_mul_ps(_mm_set1_ps(p.y), cy)),
+					_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.z), cz), _mm_set1_ps(p.w)));
+				__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(fabsf(p.x)), ex), _mm_mul_ps(_mm_set1_ps(fabsf(p.y)), ey)),
+					_mm_mul_ps(_mm_set1_ps(fabsf(p.z)), ez));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+			}
+			visible = AppendVisible(_mm_movemask_ps(inside), k, outVisible, visible);
+		}
+#endif
+		for (; k < count; k++) {
+			if (IsBoxVisible(glm::vec3(centerX[k], centerY[k], centerZ[k]), glm::vec3(extentX[k], extentY[k], extentZ[k])))
+				outVisible[visible++] = (unsigned int)k;
+		}
+		return visible;
+	}
+
+protected:
+
+	// Appends the indices of the boxes whose bit is set in mask, the first of them being box k
+	static size_t AppendVisible(int mask, size_t k, unsigned int* outVisible, size_t visible)
+	{
+		for (unsigned int bit = 0; mask; bit++, mask >>= 1) {
+			if (mask & 1)
+				outVisible[visible++] = (unsigned int)(k + bit);
+		}
+		return visible;
+	}
+
+	// The planes (a, b, c, d) of the frustum: a point p is inside when a p.x + b p.y + c p.z + d >= 0 for all of them
+	glm::vec4 planes[6];
+};
+
+#endif // !FRUSTUM_H
@@ -0,0 +1,106 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A whole file mapped read-only into memory, with mmap or CreateFileMapping on Windows.
+// Its pages are only read from disk as they are touched, and are shared by all the processes that map the same file.
+class MappedFile
+{
+public:
+	MappedFile() {}
+	~MappedFile() { Close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Returns false, with the file closed, if it cannot be opened or is empty
+	bool Open(const char* path)
+	{
+		Close();
+#ifdef _WIN32
+		fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart <= 0) {
+			Close();
+			return false;
+		}
+		size = (size_t)fileSize.QuadPart;
+		mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		data = mappingHandle ? (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+		fileDescriptor = open(path, O_RDONLY);
+		if (fileDescriptor < 0)
+			return false;
+		struct stat status;
+		if (fstat(fileDescriptor, &status) != 0 || status.st_size <= 0) {
+			Close();
+			return false;
+		}
+		size = (size_t)status.st_size;
+		void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+		data = mapping != MAP_FAILED ? (const char*)mapping : nullptr;
+#endif
+		if (!data) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void Close()
+	{
+#ifdef _WIN32
+		if (data)
+			UnmapViewOfFile(data);
+		if (mappingHandle)
+			CloseHandle(mappingHandle);
+		if (fileHandle != INVALID_HANDLE_VALUE)
+			CloseHandle(fileHandle);
+		mappingHandle = nullptr;
+		fileHandle = INVALID_HANDLE_VALUE;
+#else
+		if (data)
+			munmap((void*)data, size);
+		if (fileDescriptor >= 0)
+			close(fileDescriptor);
+		fileDescriptor = -1;
+#endif
+		data = nullptr;
+		size = 0;
+	}
+
+	bool IsOpen() const { return data != nullptr; }
+	const char* Data() const { return data; }
+	size_t Size() const { return size; }
+
+private:
+
+	const char* data = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	HANDLE fileHandle = INVALID_HANDLE_VALUE;
+	HANDLE mappingHandle = nullptr;
+#else
+	int fileDescriptor = -1;
+#endif
+};
+
+#endif // !MAPPED_FILE_H
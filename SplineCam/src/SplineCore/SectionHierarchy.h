@@ -0,0 +1,191 @@
+#ifndef SECTION_HIERARCHY_H
+#define SECTION_HIERARCHY_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <math.h>
+#include "glm/glm.hpp"
+
+// A bounding volume hierarchy over the sections of a spline, given as a structure of arrays of the centers and half extents of their boxes,
+//	or over its control points, as boxes of no extent.
+// Consecutive sections or control points of a spline are close to each other, so the tree simply pairs them up in order:
+//	it is a complete binary tree stored as an array, with them as its leaves, padded with empty boxes up to a power of two.
+// Moving a section only refits the boxes on its way to the root, in O(log sections).
+class SectionHierarchy
+{
+public:
+
+	unsigned int LeafCount() const { return leafCount; }
+
+	void Build(const std::vector<float> (&bounds)[6])
+	{
+		leafCount = bounds[0].size();
+		firstLeaf = 1;
+		while (firstLeaf < leafCount)
+			firstLeaf *= 2;
+
+		minimums.assign(2 * firstLeaf, glm::vec3(INFINITY));
+		maximums.assign(2 * firstLeaf, glm::vec3(-INFINITY));
+		for (unsigned int i = 0; i < leafCount; i++)
+			SetLeaf(i, bounds);
+		for (unsigned int node = firstLeaf - 1; node > 0; node--)
+			Merge(node);
+	}
+
+	void Build(const std::vector<glm::vec3>& points)
+	{
+		leafCount = points.size();
+		firstLeaf = 1;
+		while (firstLeaf < leafCount)
+			firstLeaf *= 2;
+
+		minimums.assign(2 * firstLeaf, glm::vec3(INFINITY));
+		maximums.assign(2 * firstLeaf, glm::vec3(-INFINITY));
+		for (unsigned int i = 0; i < leafCount; i++)
+			minimums[firstLeaf + i] = maximums[firstLeaf + i] = points[i];
+		for (unsigned int node = firstLeaf - 1; node > 0; node--)
+			Merge(node);
+	}
+
+	// Moves the i-th leaf to the point, growing its ancestors only up to the first one that already contains it.
+	// They are left loose instead of refitted, so moving a point a little at a time is O(1) amortized. Build again to tighten them.
+	void MoveLeaf(unsigned int i, const glm::vec3& point)
+	{
+		unsigned int node = firstLeaf + i;
+		minimums[node] = maximums[node] = point;
+		for (node /= 2; node > 0; node /= 2) {
+			if (glm::all(glm::lessThanEqual(minimums[node], point)) && glm::all(glm::lessThanEqual(point, maximums[node])))
+				break;
+			minimums[node] = glm::min(minimums[node], point);
+			maximums[node] = glm::max(maximums[node], point);
+		}
+	}
+
+	// Updates the box of the i-th section, and those of its ancestors
+	void Refit(unsigned int i, const std::vector<float> (&bounds)[6])
+	{
+		SetLeaf(i, bounds);
+		for (unsigned int node = (firstLeaf + i) / 2; node > 0; node /= 2)
+			Merge(node);
+	}
+
+	// Visits the sections whose boxes are closer to the position than the best squared distance found so far,
+	//	the nearest boxes first so the best distance shrinks quickly and prunes the rest.
+	// visit(i, bestSquaredDistance) must lower bestSquaredDistance to that of the closest point it finds on the i-th section.
+	template <typename Visit>
+	void FindNearest(const glm::vec3& position, float& bestSquaredDistance, Visit visit) const
+	{
+		if (leafCount == 0)
+			return;
+
+		// A child is only pushed after its sibling, so the stack holds at most one pending node per level
+		unsigned int stack[64];
+		int size = 0;
+		stack[size++] = 1;
+		while (size > 0) {
+			unsigned int node = stack[--size];
+			if (SquaredDistance(node, position) >= bestSquaredDistance)
+				continue;
+
+			if (node >= firstLeaf) {
+				visit(node - firstLeaf, bestSquaredDistance);
+				continue;
+			}
+
+			unsigned int near = 2 * node, far = 2 * node + 1;
+			if (SquaredDistance(far, position) < SquaredDistance(near, position))
+				std::swap(near, far);
+			stack[size++] = far;
+			stack[size++] = near;
+		}
+	}
+
+	// Visits the leaves whose boxes the ray reaches before the best depth found so far, within a cone around it:
+	//	a box counts as reached if the ray passes within slope times the distance from its origin, so distant leaves are as easy to pick as near ones.
+	// The direction must be normalized. visit(i, bestDepth) must lower bestDepth to that of what it picks on the i-th leaf, if anything.
+	template <typename Visit>
+	void FindAlongRay(const glm::vec3& origin, const glm::vec3& direction, float slope, float& bestDepth, Visit visit) const
+	{
+		if (leafCount == 0)
+			return;
+
+		unsigned int stack[64];
+		int size = 0;
+		stack[size++] = 1;
+		while (size > 0) {
+			unsigned int node = stack[--size];
+			if (EntryDepth(node, origin, direction, slope) >= bestDepth)
+				continue;
+
+			if (node >= firstLeaf) {
+				visit(node - firstLeaf, bestDepth);
+				continue;
+			}
+
+			unsigned int near = 2 * node, far = 2 * node + 1;
+			if (EntryDepth(far, origin, direction, slope) < EntryDepth(near, origin, direction, slope))
+				std::swap(near, far);
+			stack[size++] = far;
+			stack[size++] = near;
+		}
+	}
+
+private:
+
+	// The depth along the ray at which it enters the box of the node, grown by the cone at the farthest corner of the box,
+	//	or infinite if it misses it
+	float EntryDepth(unsigned int node, const glm::vec3& origin, const glm::vec3& direction, float slope) const
+	{
+		if (minimums[node].x > maximums[node].x)
+			return INFINITY;
+		glm::vec3 margin(slope * glm::length(glm::max(glm::abs(minimums[node] - origin), glm::abs(maximums[node] - origin))));
+		glm::vec3 minimum = minimums[node] - margin, maximum = maximums[node] + margin;
+
+		float enter = 0.0f, exit = INFINITY;
+		for (int axis = 0; axis < 3; axis++) {
+			if (direction[axis] == 0.0f) {
+				if (origin[axis] < minimum[axis] || origin[axis] > maximum[axis])
+					return INFINITY;
+				continue;
+			}
+			float t0 = (minimum[axis] - origin[axis]) / direction[axis], t1 = (maximum[axis] - origin[axis]) / direction[axis];
+			enter = std::max(enter, std::min(t0, t1));
+			exit = std::min(exit, std::max(t0, t1));
+		}
+		return enter <= exit ? enter : INFINITY;
+	}
+
+	void SetLeaf(unsigned int i, const std::vector<float> (&bounds)[6])
+	{
+		glm::vec3 center(bounds[0][i], bounds[1][i], bounds[2][i]);
+		glm::vec3 extent(bounds[3][i], bounds[4][i], bounds[5][i]);
+		minimums[firstLeaf + i] = center - extent;
+		maximums[firstLeaf + i] = center + extent;
+	}
+
+	void Merge(unsigned int node)
+	{
+		minimums[node] = glm::min(minimums[2 * node], minimums[2 * node + 1]);
+		maximums[node] = glm::max(maximums[2 * node], maximums[2 * node + 1]);
+	}
+
+	// The squared distance from the position to the box of the node, 0 inside it and infinite for empty boxes
+	float SquaredDistance(unsigned int node, const glm::vec3& position) const
+	{
+		if (minimums[node].x > maximums[node].x)
+			return INFINITY;
+		glm::vec3 d = glm::max(glm::max(minimums[node] - position, position - maximums[node]), glm::vec3(0.0f));
+		return glm::dot(d, d);
+	}
+
+	// The number of sections, and the index of the node of the first one
+	unsigned int leafCount = 0;
+	unsigned int firstLeaf = 1;
+
+	// The corners of the box of each node, the root at index 1 and the children of node n at 2n and 2n + 1
+	std::vector<glm::vec3> minimums;
+	std::vector<glm::vec3> maximums;
+};
+
+#endif // !SECTION_HIERARCHY_H
@@ -0,0 +1,1532 @@
+#ifndef SPLINE_H
+#define SPLINE_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <climits>
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "SplineBasis.h"
+#include "SplineSection.h"
+#include "SplineBatch.h"
+#include "Frustum.h"
+#include "SectionHierarchy.h"
+#include "SplineFile.h"
+#include <thread>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+// The closest point of a spline to a position: its parameter t [0, 1], the point itself and its distance to the position
+struct SplineProjection
+{
+	float t;
+	glm::vec3 point;
+	float distance;
+};
+
+// A spline defined by its control points, with its basis given at compile time by a policy (see SplineBasis.h),
+//	e.g. Spline<CatmullRomBasis>. The default Spline<> is a uniform cubic B-spline.
+// This is part of the SplineCore library, which has no dependency on GL nor on a window, so it can run headless.
+// The app draws it with SplineRenderer.
+template <typename Basis = UniformBSplineBasis>
+class Spline
+{
+
+public:
+
+	Spline() {}
+	Spline(const std::vector<glm::vec3>& controlPoints_, const std::vector<glm::vec3>& orientations_)
+		: controlPoints(controlPoints_)
+		, orientations(orientations_)
+	{
+	}
+
+	virtual ~Spline() {}
+
+	void Init(const std::vector<glm::vec3>& controlPoints_,
+		const std::vector<glm::vec3>& orientations_ = std::vector<glm::vec3>(),
+		const bool isCyclic_ = false,
+		const float adaptiveSamplingDetailAngleThreshold_ = 0.075f,
+		const float adaptiveSamplingDetailDistanceThreshold_ = 1.0f)
+	{
+		this->controlPoints = controlPoints_;
+		this->orientations = orientations_;
+		if (this->orientations.size() != this->controlPoints.size())
+			this->orientations = std::vector<glm::vec3>(this->controlPoints.size());
+		this->selectedControlPoint = 0;
+		this->adaptiveSamplingDetailAngleThreshold = adaptiveSamplingDetailAngleThreshold_;
+		this->adaptiveSamplingDetailDistanceThreshold = adaptiveSamplingDetailDistanceThreshold_;
+		this->maximumSamplingDetail = 0.001f;
+		this->drawDebugPoints = false;
+		this->isCyclic = isCyclic_;
+		this->isControlPointHierarchyStale = true;
+
+		MarkAllSectionsDirty();
+	}
+
+	// Loads the spline from a mapped file, with its control points, orientations and settings.
+	// Returns false if it was saved from a spline of another basis, or has too few control points for a single section.
+	// Its baked points, computed with the same settings, are taken as the points of its sections if there are as many,
+	//	so they are not computed again. Otherwise they are computed on the first read, as for any other spline.
+	bool Init(const SplineFileView& file)
+	{
+		if (!file.IsOpen() || file.Header().basis != Basis::Id || file.ControlPointCount() > INT_MAX
+				|| Basis::SectionCount((int)file.ControlPointCount(), file.IsCyclic()) <= 0)
+			return false;
+		const SplineFileHeader& header = file.Header();
+		this->arcLengthTolerance = header.arcLengthTolerance;
+		this->sampleBudget = header.sampleBudget;
+		Init(std::vector<glm::vec3>(file.ControlPoints(), file.ControlPoints() + file.ControlPointCount()),
+			std::vector<glm::vec3>(file.Orientations(), file.Orientations() + file.ControlPointCount()),
+			file.IsCyclic(), header.adaptiveSamplingDetailAngleThreshold, header.adaptiveSamplingDetailDistanceThreshold);
+		if (file.HasTessellation() && file.SectionCount() == (size_t)GetSectionCount())
+			LoadSplinePoints(file);
+		return true;
+	}
+
+	// Saves the spline to a file that SplineFileView can map, with its computed points and arc-length table if includeTessellation.
+	// Returns false if the file could not be written.
+	bool Save(const char* path, bool includeTessellation = true) const
+	{
+		SplineFileWriter writer;
+		if (!writer.Open(path))
+			return false;
+
+		SplineFileHeader header = {};
+		memcpy(header.magic, SplineFileMagic, sizeof(SplineFileMagic));
+		header.version = SplineFileVersion;
+		header.basis = Basis::Id;
+		header.flags = isCyclic ? (uint32_t)SplineFileCyclic : 0u;
+		header.sampleBudget = sampleBudget;
+		header.adaptiveSamplingDetailAngleThreshold = adaptiveSamplingDetailAngleThreshold;
+		header.adaptiveSamplingDetailDistanceThreshold = adaptiveSamplingDetailDistanceThreshold;
+		header.arcLengthTolerance = arcLengthTolerance;
+		header.controlPointCount = controlPoints.size();
+		header.controlPoints = writer.Append(controlPoints.data(), controlPoints.size() * sizeof(glm::vec3));
+		header.orientations = writer.Append(orientations.data(), orientations.size() * sizeof(glm::vec3));
+
+		if (includeTessellation && GetSectionCount() > 0) {
+			UpdateSplinePoints();
+			UpdateSectionStartDistances();
+			header.flags |= SplineFileTessellation;
+			header.sectionCount = GetSectionCount();
+			header.sampleCount = splinePoints.size();
+			header.sectionOffsets = writer.Append(sectionOffsets.data(), sectionOffsets.size() * sizeof(unsigned int));
+			header.splinePoints = writer.Append(splinePoints.data(), splinePoints.size() * sizeof(glm::vec3));
+			header.splineParameters = writer.Append(splineParameters.data(), splineParameters.size() * sizeof(float));
+			header.splineDistances = writer.Append(splineDistances.data(), splineDistances.size() * sizeof(float));
+			header.sectionStartDistances = writer.Append(sectionStartDistances.data(), sectionStartDistances.size() * sizeof(float));
+		}
+
+		header.fileSize = writer.Size();
+		return writer.Close(header);
+	}
+
+	// Returns the value of the spline for the given value of the parameter t [0, 1]
+	glm::vec3 GetPoint(float t) const {
+		int sections = GetSectionCount();
+		t = t < 0 ? 0 : t > 1 ? 1 : t;
+		t *= sections;
+		int i = (int)t;
+		i = i < sections ? i : sections - 1;
+		return GetPoint(t - i, i);
+	}
+	
+	glm::vec3 GetTangent(float t) const {
+		int sections = GetSectionCount();
+		t = t < 0 ? 0 : t > 1 ? 1 : t;
+		t *= sections;
+		int i = (int)t;
+		i = i < sections ? i : sections - 1;
+		return GetOrientation(t - i, i);
+	}
+
+	// Returns the value of the parameter t [0, 1] at the given distance [0, length] along the spline.
+	// The arc-length table is searched in O(log n) and then inverted locally between its two enclosing samples.
+	float GetParameterAtDistance(float distance) const {
+		UpdateSplinePoints();
+		UpdateSectionStartDistances();
+		int sections = GetSectionCount();
+		if (sections <= 0 || length <= 0.0f)
+			return 0.0f;
+		distance = distance < 0 ? 0 : distance > length ? length : distance;
+
+		// Find the section and the samples inside it that enclose the distance
+		int i = std::upper_bound(sectionStartDistances.begin(), sectionStartDistances.end(), distance) - sectionStartDistances.begin() - 1;
+		i = i < 0 ? 0 : i < sections ? i : sections - 1;
+		const float* distances = &splineDistances[sectionOffsets[i]];
+		const float* parameters = &splineParameters[sectionOffsets[i]];
+		int samples = sectionOffsets[i + 1] - sectionOffsets[i];
+		float localDistance = distance - sectionStartDistances[i];
+		int j = std::upper_bound(distances, distances + samples, localDistance) - distances;
+		j = j < 1 ? 1 : j < samples ? j : samples - 1;
+
+		float segment = distances[j] - distances[j - 1];
+		float f = segment > 0.0f ? (localDistance - distances[j - 1]) / segment : 0.0f;
+		float t0 = parameters[j - 1], t1 = parameters[j];
+		float t = t0 + (t1 - t0) * f;
+
+		// Refine with Newton steps until they converge, so the point lies at the right arc length from the previous sample.
+		// Dense samples take one or two, the sparse ones of a small sample budget a few more.
+		float target = localDistance - distances[j - 1];
+		for (int k = 0; k < 8 && target > 0.0f; k++) {
+			float slope = glm::length(GetDerivative(t, i));
+			if (slope <= 0.0f)
+				break;
+			float step = (GetArcLength(t0, t, i) - target) / slope;
+			t -= step;
+			t = t < t0 ? t0 : t > t1 ? t1 : t;
+			if (fabsf(step) < 1e-6f)
+				break;
+		}
+
+		return (i + t) / sections;
+	}
+
+	// Returns the distance along the spline [0, length] at the given value of the parameter t [0, 1]
+	float GetDistanceAtParameter(float t) const {
+		UpdateSplinePoints();
+		UpdateSectionStartDistances();
+		int sections = GetSectionCount();
+		if (sections <= 0)
+			return 0.0f;
+		t = t < 0 ? 0 : t > 1 ? 1 : t;
+		t *= sections;
+		int i = (int)t;
+		i = i < sections ? i : sections - 1;
+		t -= i;
+
+		const float* distances = &splineDistances[sectionOffsets[i]];
+		int j = FindSample(t, i);
+
+		// Integrated from the previous sample, consistently with GetParameterAtDistance
+		float arc = GetArcLength(splineParameters[sectionOffsets[i] + j - 1], t, i);
+		arc = arc < distances[j] - distances[j - 1] ? arc : distances[j] - distances[j - 1];
+		return sectionStartDistances[i] + distances[j - 1] + arc;
+	}
+
+	// Returns the frame of the spline at the given value of the parameter t [0, 1]: its forward vector, as GetTangent(t),
+	//	and an up vector that rolls as little as possible along the curve, interpolated from the precomputed frames.
+	// The forward vector is evaluated exactly, as the samples may be too sparse to follow the blending of the custom orientations.
+	// The frames are only computed on the first call after an edit, and from the first section it changed onwards.
+	void GetFrame(float t, glm::vec3& forward, glm::vec3& up) const {
+		UpdateSplinePoints();
+		UpdateSplineFrames();
+		if (isCyclic)
+			UpdateSectionStartDistances();
+		int sections = GetSectionCount();
+		if (sections <= 0)
+			return;
+		t = t < 0 ? 0 : t > 1 ? 1 : t;
+		t *= sections;
+		int i = (int)t;
+		i = i < sections ? i : sections - 1;
+		t -= i;
+
+		int j = FindSample(t, i);
+		unsigned int k = sectionOffsets[i] + j;
+		float segment = splineParameters[k] - splineParameters[k - 1];
+		float f = segment > 0.0f ? (t - splineParameters[k - 1]) / segment : 0.0f;
+		forward = GetOrientation(t, i);
+		up = GetTwistedUp(k - 1, i) + (GetTwistedUp(k, i) - GetTwistedUp(k - 1, i)) * f;
+		up = glm::normalize(up - glm::dot(up, forward) * forward);
+	}
+
+	// Evaluates the spline for count values of the parameter t [0, 1] at once, into the caller-provided arrays of output.
+	// Matches GetPoint(t) for the points, while the tangents are those of the curve itself, without the custom orientations.
+	// Writes nothing if the spline has no sections.
+	void EvaluateBatch(const float* t, size_t count, const SplineBatchOutput& output) const {
+		static_assert(sizeof(SectionCoefficients) % sizeof(float) == 0, "Section coefficients must be made of floats only");
+		if (GetSectionCount() == 0)
+			return;
+		SplineBatchKernels::Evaluate(&sectionCoefficients[0].a.x, sizeof(SectionCoefficients) / sizeof(float),
+			GetSectionCount(), t, count, output);
+	}
+
+	// Arc-length parameterized versions of GetPoint and GetTangent, for moving along the spline at constant speed
+	glm::vec3 GetPointAtDistance(float distance) const { return GetPoint(GetParameterAtDistance(distance)); }
+	glm::vec3 GetTangentAtDistance(float distance) const { return GetTangent(GetParameterAtDistance(distance)); }
+
+	void NextControlPoint() { selectedControlPoint = (selectedControlPoint + 1) % controlPoints.size(); }
+	void PreviousControlPoint() { selectedControlPoint = selectedControlPoint == 0 ? controlPoints.size() - 1 : selectedControlPoint - 1; }
+	void SelectControlPoint(unsigned int i) { selectedControlPoint = i < controlPoints.size() ? i : selectedControlPoint; }
+	void TranslateControlPoint(glm::vec3 translate) { 
+		controlPoints[selectedControlPoint] += translate; 
+		MarkControlPointDirty(selectedControlPoint);
+		RecordControlPointChange(selectedControlPoint);
+		if (!isControlPointHierarchyStale)
+			controlPointHierarchy.MoveLeaf(selectedControlPoint, controlPoints[selectedControlPoint]);
+	}
+	void RotateControlPoint(float dx, float dy) {
+		if (orientations[selectedControlPoint] == glm::vec3())
+			orientations[selectedControlPoint] = glm::vec3(1.0f, 0.0f, 0.0f);
+
+		glm::mat4 mat(1);
+		mat = glm::rotate(mat, dy, glm::vec3(0.0f, 1.0f, 0.0f));
+		mat = glm::rotate(mat, dx, glm::cross(orientations[selectedControlPoint], glm::vec3(0.0f, 1.0f, 0.0f)));
+		orientations[selectedControlPoint] = glm::normalize(glm::vec3(mat * glm::vec4(orientations[selectedControlPoint], 1.0f)));
+		MarkOrientationDirty(selectedControlPoint);
+		RecordControlPointChange(selectedControlPoint);
+	}
+
+	// Inserts a control point right after the one the section at the parameter t [0, 1] starts from, at the given position,
+	//	or at the point of the curve at t if none is given. Returns the parameter at which the section starting from the new control point starts.
+	float CreateControlPoint(float t, glm::vec3 position = glm::vec3(), glm::vec3 orientation = glm::vec3()) {
+		int sections = GetSectionCount();
+		int i = controlPoints.size();
+		if (sections > 0) {
+			t = t < 0 ? 0 : t > 1 ? 1 : t;
+			t *= sections;
+			int section = (int)t;
+			section = section < sections ? section : sections - 1;
+			if (position == glm::vec3())
+				position = GetPoint(t - section, section);
+			i = Basis::Stride * section + Basis::Offset + Basis::SectionStart + 1;
+			i = i < 0 ? 0 : i < (int)controlPoints.size() ? i : controlPoints.size();
+		}
+
+		controlPoints.insert(controlPoints.begin() + i, position);
+		orientations.insert(orientations.begin() + i, orientation);
+		isControlPointHierarchyStale = true;
+
+		selectedControlPoint = i;
+		if (HasSlidingWindow) {
+			InsertSection(i);
+			MarkControlPointDirty(i);
+		}
+		else {
+			MarkAllSectionsDirty();
+		}
+
+		sections = GetSectionCount();
+		if (sections <= 0)
+			return 0.0f;
+		int section = (i - Basis::Offset - Basis::SectionStart) / Basis::Stride;
+		section = section < 0 ? 0 : section < sections ? section : sections;
+		return (float)section / sections;
+	}
+
+	// Deletes the selected control point and selects the one before it. Returns the parameter at which the point of the curve that was at t lies now,
+	//	mapped over the sections as in CreateControlPoint.
+	float DeleteControlPoint(float t) {
+		if (controlPoints.size() > 2) {
+			int sections = GetSectionCount();
+			int section = 0;
+			float f = 0.0f;
+			if (sections > 0) {
+				t = t < 0 ? 0 : t > 1 ? 1 : t;
+				t *= sections;
+				section = (int)t;
+				section = section < sections ? section : sections - 1;
+				f = t - section;
+			}
+			int deleted = selectedControlPoint;
+			int start = Basis::Stride * section + Basis::Offset + Basis::SectionStart;
+
+			controlPoints.erase(controlPoints.begin() + selectedControlPoint);
+			orientations.erase(orientations.begin() + selectedControlPoint);
+			isControlPointHierarchyStale = true;
+			if (HasSlidingWindow) {
+				EraseSection(selectedControlPoint);
+				MarkSectionsDirty((int)selectedControlPoint - 2, selectedControlPoint);
+			}
+			else {
+				MarkAllSectionsDirty();
+			}
+
+			if (selectedControlPoint != 0)
+				PreviousControlPoint();
+
+			// The sections past the deleted control point start from the one before theirs, and the one starting from it is merged into the one before it
+			if (start == deleted)
+				f = start == 0 ? 0.0f : (1 + f) * 0.5f;
+			if (start >= deleted && start > 0)
+				start--;
+
+			sections = GetSectionCount();
+			if (sections <= 0)
+				return 0.0f;
+			section = start - Basis::Offset - Basis::SectionStart;
+			section = section < 0 ? 0 : section / Basis::Stride;
+			if (section >= sections) {
+				section = sections - 1;
+				f = 1.0f;
+			}
+			return (section + f) / sections;
+		}
+
+		return t;
+	}
+
+	void DeleteCustomOrientation() {
+		orientations[selectedControlPoint] = glm::vec3();
+		MarkOrientationDirty(selectedControlPoint);
+		RecordControlPointChange(selectedControlPoint);
+	}
+
+	void ToggleDebugPoints() { drawDebugPoints = !drawDebugPoints; }
+
+	const std::vector<glm::vec3>& ControlPoints() const { return controlPoints; }
+	const std::vector<glm::vec3>& Orientations() const { return orientations; }
+	const glm::vec3& SelectedControlPoint() const { return controlPoints[selectedControlPoint]; }
+	unsigned int SelectedControlPointIndex() const { return selectedControlPoint; }
+	bool DrawDebugPoints() const { return drawDebugPoints; }
+	bool IsCyclic() const { return isCyclic; }
+	static constexpr bool IsInterpolating() { return Basis::IsInterpolating; }
+
+	void PrintControlPoints() const
+	{
+		for (auto& point : controlPoints)
+		{
+			printf("( %f, %f, %f)\n", point.x, point.y, point.z);
+		}
+		printf("Length: %f\n", GetLength());
+	}
+
+	void ToggleCyclicOrClamped() { isCyclic = !isCyclic; MarkAllSectionsDirty(); }
+
+	float GetLength() const { UpdateSplinePoints(); return length; }
+
+	// Sets the largest error allowed in the arc length of each section, integrated by adaptive Gauss-Legendre quadrature
+	void SetArcLengthTolerance(float tolerance) { arcLengthTolerance = tolerance; MarkAllSectionsDirty(); }
+	float ArcLengthTolerance() const { return arcLengthTolerance; }
+
+	// Switches to a fixed number of computed points for the whole spline, spent where the curve is least flat, or back to
+	//	the adaptive sampling of each section with 0. The budget is raised to 2 points per section if it does not reach them.
+	// The budget is spread across all sections, so any edit recomputes all of them.
+	void SetSampleBudget(unsigned int budget) { sampleBudget = budget; MarkAllSectionsDirty(); }
+	unsigned int SampleBudget() const { return sampleBudget; }
+
+	// Increases with every change to the control points or their orientations, so views of the spline know when to refresh
+	unsigned int Revision() const { return revision; }
+
+	// The computed points of all sections, one after the other.
+	// Each section may end with its end point repeated, to fill the room it is laid out with to be recomputed in place.
+	const std::vector<glm::vec3>& GetSplinePoints() const { UpdateSplinePoints(); return splinePoints; }
+
+	// The index of the first computed point of each section, with the total number of points at the end
+	const std::vector<unsigned int>& GetSectionOffsets() const { UpdateSplinePoints(); return sectionOffsets; }
+
+	// Writes the sections whose computed points were rewritten in place since the given revision to outSections, and the control points
+	//	moved or turned since to outControlPoints, in the order they changed and possibly more than once, so views that keep a copy of
+	//	the spline only refresh those. Returns false, with neither written, if the points were laid out again since, as sections were added,
+	//	removed or moved, or the changes were too many to keep, in which case the whole copy has to be refreshed.
+	bool GetChangesSince(unsigned int sinceRevision, std::vector<unsigned int>& outSections, std::vector<unsigned int>& outControlPoints) const {
+		UpdateSplinePoints();
+		outSections.clear();
+		outControlPoints.clear();
+		if (layoutRevision > sinceRevision)
+			return false;
+		GetChangesAfter(rewrittenSections, sinceRevision, outSections);
+		GetChangesAfter(changedControlPoints, sinceRevision, outControlPoints);
+		return true;
+	}
+
+	// The number of levels of detail of each section. Level 0 is made of all its computed points,
+	//	and every other level of a subset of them, simplified within a tolerance 4 times as large as the previous level.
+	static constexpr int LevelOfDetailCount = 4;
+
+	// The points of the i-th section at the given level of detail [1, LevelOfDetailCount), as the range of GetLevelOfDetailIndices
+	//	with their indices into its own computed points.
+	// The levels of a section are only simplified from its points on the first request after it changed, which may compact the indices
+	//	of all sections, so the ranges are only valid until the next request of a section that changed.
+	void GetSectionLevelOfDetail(int i, int level, unsigned int& outFirst, unsigned int& outCount) const {
+		UpdateSplinePoints();
+		UpdateLevelsOfDetail(i);
+		int slot = i * (LevelOfDetailCount - 1) + level - 1;
+		outFirst = levelOfDetailFirsts[slot];
+		outCount = levelOfDetailCounts[slot];
+	}
+
+	// The indices of the levels of detail of all sections. Those of a section are appended past the end on its first request after it changed,
+	//	so a copy of them only needs the new ones, unless they were compacted since, which LevelOfDetailCompactions counts.
+	const std::vector<unsigned int>& GetLevelOfDetailIndices() const { return levelOfDetailIndices; }
+	unsigned int LevelOfDetailCompactions() const { return levelOfDetailCompactions; }
+
+	// The largest distance from the computed points of the i-th section to its drawn lines at the given level of detail
+	float GetSectionLevelOfDetailError(int i, int level) const {
+		if (level == 0)
+			return 0.0f;
+		UpdateSplinePoints();
+		UpdateLevelsOfDetail(i);
+		return levelOfDetailErrors[i * (LevelOfDetailCount - 1) + level - 1];
+	}
+
+	// The bounding box of the computed points of the i-th section
+	void GetSectionBounds(int i, glm::vec3& outCenter, glm::vec3& outExtent) const {
+		UpdateSplinePoints();
+		outCenter = glm::vec3(sectionBounds[0][i], sectionBounds[1][i], sectionBounds[2][i]);
+		outExtent = glm::vec3(sectionBounds[3][i], sectionBounds[4][i], sectionBounds[5][i]);
+	}
+
+	// Writes the indices of the sections at least partially inside the frustum, in order, to outSections.
+	// Each section is tested by the bounding box of its computed points.
+	void GetVisibleSections(const Frustum& frustum, std::vector<unsigned int>& outSections) const {
+		UpdateSplinePoints();
+		int sections = GetSectionCount();
+		outSections.resize(sections);
+		outSections.resize(frustum.CullBoxes(sectionBounds[0].data(), sectionBounds[1].data(), sectionBounds[2].data(),
+			sectionBounds[3].data(), sectionBounds[4].data(), sectionBounds[5].data(), sections, outSections.data()));
+	}
+
+	// Returns the closest point of the spline to the position.
+	// The sections are searched through a hierarchy of their bounding boxes, nearest first, skipping those farther than the best point so far,
+	//	and the closest sample of each section visited is refined on its polynomial with Newton steps.
+	SplineProjection ClosestPoint(const glm::vec3& position) const {
+		UpdateSplinePoints();
+		return Project(position);
+	}
+
+	// Finds the closest points of the spline to count positions, split across threadCount threads, or as many as the hardware runs if 0
+	void ClosestPoints(const glm::vec3* positions, size_t count, SplineProjection* outProjections, unsigned int threadCount = 0) const {
+		UpdateSplinePoints();
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		// Not worth a thread for fewer positions than this
+		const size_t minimumPerThread = 256;
+		size_t threads = std::max<size_t>(1, std::min<size_t>(threadCount, count / minimumPerThread));
+		size_t perThread = (count + threads - 1) / threads;
+
+		auto project = [=](size_t first, size_t last) {
+			for (size_t k = first; k < last; k++)
+				outProjections[k] = Project(positions[k]);
+		};
+		std::vector<std::thread> workers;
+		for (size_t first = perThread; first < count; first += perThread)
+			workers.emplace_back(project, first, std::min(first + perThread, count));
+		project(0, std::min(perThread, count));
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	// Returns the index of the first control point hit by the ray, or -1 if none is.
+	// A control point is hit if the ray passes within slope times its distance from the origin, i.e. within a cone of that slope around the ray.
+	// The direction must be normalized.
+	int PickControlPoint(const glm::vec3& origin, const glm::vec3& direction, float slope) const {
+		if (isControlPointHierarchyStale) {
+			controlPointHierarchy.Build(controlPoints);
+			isControlPointHierarchyStale = false;
+		}
+
+		int picked = -1;
+		float depth = INFINITY;
+		controlPointHierarchy.FindAlongRay(origin, direction, slope, depth, [&](unsigned int i, float& bestDepth) {
+			glm::vec3 d = controlPoints[i] - origin;
+			float along = glm::dot(d, direction);
+			if (along > 0.0f && along < bestDepth && glm::length(d - direction * along) <= slope * along) {
+				bestDepth = along;
+				picked = i;
+			}
+		});
+		return picked;
+	}
+
+	// Finds the first point of the curve hit by the ray, within a cone of the given slope around it as in PickControlPoint.
+	// Returns whether there is any, and its parameter t [0, 1] in outT.
+	bool PickCurve(const glm::vec3& origin, const glm::vec3& direction, float slope, float& outT) const {
+		UpdateSplinePoints();
+		int sections = GetSectionCount();
+		bool isPicked = false;
+		float depth = INFINITY;
+		sectionHierarchy.FindAlongRay(origin, direction, slope, depth, [&](unsigned int i, float& bestDepth) {
+			const glm::vec3* points = &splinePoints[sectionOffsets[i]];
+			const float* parameters = &splineParameters[sectionOffsets[i]];
+			int samples = sectionOffsets[i + 1] - sectionOffsets[i];
+			for (int j = 1; j < samples; j++) {
+				// The closest point of the segment to the line of the ray, as a fraction f of the segment
+				glm::vec3 segment = points[j] - points[j - 1], w = points[j - 1] - origin;
+				float b = glm::dot(direction, segment), c = glm::dot(segment, segment);
+				float denominator = c - b * b;
+				float f = denominator > 1e-12f ? (b * glm::dot(direction, w) - glm::dot(segment, w)) / denominator : 0.0f;
+				f = f < 0.0f ? 0.0f : f > 1.0f ? 1.0f : f;
+
+				glm::vec3 d = w + segment * f;
+				float along = glm::dot(d, direction);
+				if (along > 0.0f && along < bestDepth && glm::length(d - direction * along) <= slope * along) {
+					bestDepth = along;
+					outT = (i + parameters[j - 1] + (parameters[j] - parameters[j - 1]) * f) / sections;
+					isPicked = true;
+				}
+			}
+		});
+		return isPicked;
+	}
+
+protected:
+
+	// Whether each section starts one control point after the previous one, as in B-splines or Catmull-Rom splines.
+	// Inserting or erasing a control point then only adds or removes one section, instead of shifting all that follow.
+	static constexpr bool HasSlidingWindow = Basis::Stride == 1 && Basis::Offset == -1;
+
+	// The number of sections covered by the parameter t [0, 1]
+	int GetSectionCount() const { 
+		int sections = Basis::SectionCount(controlPoints.size(), isCyclic);
+		return sections > 0 ? sections : 0;
+	}
+
+	int GetIndex(int i) const {
+		int n = controlPoints.size() - !isCyclic;
+		if (!isCyclic)
+			return i < 0 ? 0 : (i < n ? i : n);
+		else
+			return i < 0 ? (i % -n) + n : i % n;
+	}
+
+	// The i-th spline section as a polynomial in the parameter t [0, 1]: a + bt + ct^2 + dt^3,
+	//	and its first derivative: da + db t + dc t^2
+	typedef SplineSectionCoefficients SectionCoefficients;
+
+	// Converts the i-th spline section from the basis of the spline to the polynomial basis
+	void CalculateSectionCoefficients(int i) {
+		int first = Basis::Stride * i + Basis::Offset;
+		SplineSection::CalculateCoefficients<Basis>(controlPoints[GetIndex(first)], controlPoints[GetIndex(first + 1)],
+			controlPoints[GetIndex(first + 2)], controlPoints[GetIndex(first + 3)], sectionCoefficients[i]);
+	}
+
+	// Calculates the value of the i-th spline section for the given value of the parameter t [0, 1]
+	glm::vec3 GetPoint(float t, int i) const {
+		return SplineSection::GetPoint(sectionCoefficients[i], t);
+	}
+
+	glm::vec3 GetOrientation(float t, int i) const {
+		int first = Basis::Stride * i + Basis::Offset;
+		return SplineSection::GetOrientation(sectionCoefficients[i], t,
+			orientations[GetIndex(first + Basis::SectionStart)], orientations[GetIndex(first + Basis::SectionEnd)]);
+	}
+
+	glm::vec3 GetTangent(float t, int i) const {
+		return glm::normalize(GetDerivative(t, i));
+	}
+
+	// Calculates the (non-normalized) first derivative of the i-th spline section for the given value of the parameter t [0, 1]
+	glm::vec3 GetDerivative(float t, int i) const {
+		return SplineSection::GetDerivative(sectionCoefficients[i], t);
+	}
+
+	// Integrates the speed of the i-th section from t0 to t1 with 5-point Gauss-Legendre quadrature
+	float GetArcLength(float t0, float t1, int i) const {
+		return SplineSection::GetArcLength(sectionCoefficients[i], t0, t1);
+	}
+
+	// Integrates the speed of the i-th section from t0 to t1 to within the tolerance, halving the intervals
+	//	whose 5-point estimate differs from the sum of those of their halves by more than their share of it
+	float CalculateArcLength(float t0, float t1, int i, float tolerance) const {
+		struct QuadratureInterval { float t0, t1, estimate; int depth; };
+		QuadratureInterval stack[MaximumQuadratureDepth + 1];
+		int size = 0;
+		stack[size++] = { t0, t1, GetArcLength(t0, t1, i), 0 };
+
+		float length = 0.0f;
+		while (size > 0) {
+			QuadratureInterval interval = stack[--size];
+			float middle = (interval.t0 + interval.t1) * 0.5f;
+			float first = GetArcLength(interval.t0, middle, i), second = GetArcLength(middle, interval.t1, i);
+			float share = tolerance * (interval.t1 - interval.t0) / (t1 - t0);
+			if (interval.depth == MaximumQuadratureDepth || fabsf(first + second - interval.estimate) <= share) {
+				length += first + second;
+				continue;
+			}
+			// Depth-first, so the stack never holds more than one pending half per level
+			stack[size++] = { middle, interval.t1, second, interval.depth + 1 };
+			stack[size++] = { interval.t0, middle, first, interval.depth + 1 };
+		}
+		return length;
+	}
+
+	static constexpr int MaximumQuadratureDepth = 16;
+
+	// The closest point of the spline to the position, once its points are up to date. Only reads the spline, so it can run on many threads at once.
+	SplineProjection Project(const glm::vec3& position) const {
+		int sections = GetSectionCount();
+		SplineProjection best = { 0.0f, glm::vec3(), INFINITY };
+		float nearestSquaredDistance = INFINITY;
+		sectionHierarchy.FindNearest(position, nearestSquaredDistance, [&](unsigned int i, float& bestSquaredDistance) {
+			float t = ProjectOntoSection(position, i);
+			glm::vec3 point = GetPoint(t, i);
+			float squaredDistance = glm::dot(point - position, point - position);
+			if (squaredDistance < bestSquaredDistance) {
+				bestSquaredDistance = squaredDistance;
+				best = { (i + t) / sections, point, sqrtf(squaredDistance) };
+			}
+		});
+		return best;
+	}
+
+	// Returns the parameter t [0, 1] of the closest point of the i-th section to the position.
+	// Starts from the closest point of its samples, then takes Newton steps towards a zero of the derivative of the squared distance,
+	//	keeping the starting point if they lead farther. Where the squared distance is not convex, as along the long, unevenly fast sections
+	//	of decimated splines, the step falls back to Gauss-Newton, which ignores the curvature of the section.
+	float ProjectOntoSection(const glm::vec3& position, int i) const {
+		const glm::vec3* points = &splinePoints[sectionOffsets[i]];
+		const float* parameters = &splineParameters[sectionOffsets[i]];
+		int samples = sectionOffsets[i + 1] - sectionOffsets[i];
+
+		float start = 0.0f, startSquaredDistance = INFINITY;
+		for (int j = 1; j < samples; j++) {
+			glm::vec3 segment = points[j] - points[j - 1];
+			float squaredLength = glm::dot(segment, segment);
+			float f = squaredLength > 0.0f ? glm::clamp(glm::dot(position - points[j - 1], segment) / squaredLength, 0.0f, 1.0f) : 0.0f;
+			glm::vec3 d = points[j - 1] + segment * f - position;
+			if (glm::dot(d, d) < startSquaredDistance) {
+				startSquaredDistance = glm::dot(d, d);
+				start = parameters[j - 1] + (parameters[j] - parameters[j - 1]) * f;
+			}
+		}
+
+		const SectionCoefficients& coefficients = sectionCoefficients[i];
+		float t = start;
+		for (int k = 0; k < 8; k++) {
+			glm::vec3 d = GetPoint(t, i) - position;
+			glm::vec3 first = GetDerivative(t, i);
+			glm::vec3 second = coefficients.db + 2.0f * t * coefficients.dc;
+			float slope = glm::dot(first, first) + glm::dot(d, second);
+			if (slope <= 0.0f)
+				slope = glm::dot(first, first);
+			if (slope <= 0.0f)
+				break;
+			float step = glm::dot(d, first) / slope;
+			t -= step;
+			t = t < 0.0f ? 0.0f : t > 1.0f ? 1.0f : t;
+			if (fabsf(step) < 1e-6f)
+				break;
+		}
+
+		glm::vec3 d = GetPoint(t, i) - position, s = GetPoint(start, i) - position;
+		return glm::dot(d, d) <= glm::dot(s, s) ? t : start;
+	}
+
+	// Returns the index j [1, samples - 1], local to the i-th section, of the first computed point past its parameter t [0, 1]
+	int FindSample(float t, int i) const {
+		const float* parameters = &splineParameters[sectionOffsets[i]];
+		int samples = sectionOffsets[i + 1] - sectionOffsets[i];
+		int j = std::upper_bound(parameters, parameters + samples, t) - parameters;
+		return j < 1 ? 1 : j < samples ? j : samples - 1;
+	}
+
+	// An interval of a spline section pending to be subdivided, or an already computed point pending to be appended
+	struct SubdivisionInterval
+	{
+		float t0, t1;
+		glm::vec3 x0, x1, m0, m1;
+		bool isPoint;
+	};
+
+	// Appends the points strictly between t = 0 and t = 1 of the i-th section to outPoints, and the values of their parameter to outParameters.
+	// The subdivision runs depth-first over an explicit stack, so the points are appended in order without recursion nor temporary vectors.
+	void CalculateAdaptiveSubdivision(int i, glm::vec3 x0, glm::vec3 x1, glm::vec3 m0, glm::vec3 m1,
+		std::vector<glm::vec3>& outPoints, std::vector<float>& outParameters) const {
+		subdivisionStack.clear();
+		subdivisionStack.push_back({ 0.0f, 1.0f, x0, x1, m0, m1, false });
+
+		while (!subdivisionStack.empty()) {
+			SubdivisionInterval interval = subdivisionStack.back();
+			subdivisionStack.pop_back();
+
+			if (interval.isPoint) {
+				outPoints.push_back(interval.x0);
+				outParameters.push_back(interval.t0);
+				continue;
+			}
+
+			if (interval.t1 - interval.t0 < maximumSamplingDetail || interval.x0 == interval.x1) { // Avoid infinite subdivision
+				continue;
+			}
+
+			float t = (interval.t0 + interval.t1) * 0.5f;
+			glm::vec3 x = GetPoint(t, i);
+			glm::vec3 m = GetTangent(t, i);
+
+			// Curve is consider a line when the tangent in the middle point is practically the same as the tangents in both extremes
+			// This works because only one inflection point maximum will exist inside a bspline section.
+			// Hence, if the middle point's tangent is aligned with its extreme, it has to be a line. 
+			// If it was a more complex curve, there would have to be more than one inflection point.
+			if (glm::acos(glm::clamp(glm::dot(interval.m0, m), -1.0f, 1.0f)) < adaptiveSamplingDetailAngleThreshold &&
+					glm::acos(glm::clamp(glm::dot(interval.m1, m), -1.0f, 1.0f)) < adaptiveSamplingDetailAngleThreshold) {
+
+				// Extra text for long almost straight lines
+				if (glm::distance(x, interval.x0 + (interval.x1 - interval.x0) * glm::dot(x - interval.x0, interval.x1 - interval.x0)) < adaptiveSamplingDetailDistanceThreshold) {
+					continue;
+				}
+			}
+
+			// Pushed in reverse order, so the first half is completed first, then the middle point, then the second half
+			subdivisionStack.push_back({ t, interval.t1, x, interval.x1, m, interval.m1, false });
+			subdivisionStack.push_back({ t, t, x, x, m, m, true });
+			subdivisionStack.push_back({ interval.t0, t, interval.x0, x, interval.m0, m, false });
+		}
+	}
+
+	// An interval of a spline section pending to be split by the budgeted subdivision
+	struct RefinementInterval
+	{
+		int i;
+		float t0, t1;
+		glm::vec3 x0, x1, d0, d1;
+	};
+
+	// The key of a pending interval in the queue: the squared distance of the inner Bezier control points of the interval
+	//	from its chord, which bounds how far the curve strays from it, and where the interval is stored.
+	// The queue only moves these around, not the intervals themselves.
+	struct RefinementKey
+	{
+		float error;
+		unsigned int interval;
+
+		bool operator<(const RefinementKey& other) const { return error < other.error; }
+	};
+
+	// A point computed by the budgeted subdivision, strictly inside its section
+	struct RefinementPoint
+	{
+		int i;
+		float t;
+		glm::vec3 x;
+
+		bool operator<(const RefinementPoint& other) const { return i < other.i || (i == other.i && t < other.t); }
+	};
+
+	// Queues the interval, storing it in the given slot of refinementIntervals, or in a new one if it is past the end
+	void PushRefinementInterval(unsigned int slot, int i, float t0, float t1, const glm::vec3& x0, const glm::vec3& x1, const glm::vec3& d0, const glm::vec3& d1) const {
+		if (t1 - t0 < maximumSamplingDetail || x0 == x1) // Avoid infinite subdivision
+			return;
+		float third = (t1 - t0) / 3.0f;
+		float error = std::max(SquaredDistanceToSegment(x0 + d0 * third, x0, x1), SquaredDistanceToSegment(x1 - d1 * third, x0, x1));
+		if (slot < refinementIntervals.size())
+			refinementIntervals[slot] = { i, t0, t1, x0, x1, d0, d1 };
+		else {
+			slot = refinementIntervals.size();
+			refinementIntervals.push_back({ i, t0, t1, x0, x1, d0, d1 });
+		}
+		refinementQueue.push_back({ error, slot });
+		std::push_heap(refinementQueue.begin(), refinementQueue.end());
+	}
+
+	// Computes the points strictly inside all sections for the sample budget into refinementPoints, sorted by section and parameter.
+	// The interval with the largest error across the whole spline is always split first, so the points go where they reduce it most,
+	//	and both the points and the pending intervals are bounded by the budget.
+	void CalculateBudgetedSubdivision(int sections) const {
+		refinementIntervals.clear();
+		refinementQueue.clear();
+		refinementPoints.clear();
+		unsigned int splits = sampleBudget > 2u * sections ? sampleBudget - 2u * sections : 0;
+		refinementIntervals.reserve(sections + splits + 1);
+		refinementQueue.reserve(sections + splits + 1);
+		refinementPoints.reserve(splits);
+
+		for (int i = 0; i < sections; i++)
+			PushRefinementInterval(UINT_MAX, i, 0.0f, 1.0f, GetPoint(0.0f, i), GetPoint(1.0f, i), GetDerivative(0.0f, i), GetDerivative(1.0f, i));
+
+		while (refinementPoints.size() < splits && !refinementQueue.empty() && refinementQueue.front().error > 0.0f) {
+			std::pop_heap(refinementQueue.begin(), refinementQueue.end());
+			unsigned int slot = refinementQueue.back().interval;
+			RefinementInterval interval = refinementIntervals[slot];
+			refinementQueue.pop_back();
+
+			// The first half takes over the slot of the interval split
+			float t = (interval.t0 + interval.t1) * 0.5f;
+			glm::vec3 x = GetPoint(t, interval.i);
+			glm::vec3 d = GetDerivative(t, interval.i);
+			refinementPoints.push_back({ interval.i, t, x });
+			PushRefinementInterval(slot, interval.i, interval.t0, t, interval.x0, x, interval.d0, d);
+			PushRefinementInterval(UINT_MAX, interval.i, t, interval.t1, x, interval.x1, d, interval.d1);
+		}
+
+		std::sort(refinementPoints.begin(), refinementPoints.end());
+	}
+
+	// A section or a control point that changed, with the revision it changed at
+	struct Change
+	{
+		unsigned int revision;
+		unsigned int index;
+	};
+
+	// Appends the indices of the changes made after the given revision to outIndices. The changes are in order of revision.
+	static void GetChangesAfter(const std::vector<Change>& changes, unsigned int revision, std::vector<unsigned int>& outIndices) {
+		auto change = std::upper_bound(changes.begin(), changes.end(), revision,
+			[](unsigned int since, const Change& other) { return since < other.revision; });
+		for (; change != changes.end(); ++change)
+			outIndices.push_back(change->index);
+	}
+
+	// The most changes of each kind kept for GetChangesSince, so keeping them stays cheap on edits across a long path.
+	// A view refreshed every frame reads them long before, so it is rarely told to refresh all of the spline because of it.
+	static constexpr size_t MaxKeptChanges = 1024;
+
+	// Records that the i-th control point was moved or turned, for GetChangesSince.
+	// Once the changes kept outnumber the control points, or reach the most kept, views are told to refresh them all instead.
+	void RecordControlPointChange(unsigned int i) {
+		if (changedControlPoints.size() >= std::min(controlPoints.size(), MaxKeptChanges)) {
+			ForgetChanges();
+			return;
+		}
+		changedControlPoints.push_back({ revision, i });
+	}
+
+	// Drops the changes kept for GetChangesSince, so views of the spline refresh all of it
+	void ForgetChanges() const {
+		layoutRevision = revision;
+		rewrittenSections.clear();
+		changedControlPoints.clear();
+	}
+
+	// Marks the sections from first to last as needing to be recomputed, wrapping around if the spline is cyclic.
+	// Their coefficients are updated straight away, so the spline can still be evaluated before its points are recomputed.
+	void MarkSectionsDirty(int first, int last) {
+		int n = dirtySections.size();
+		if (last - first + 1 >= n) {
+			MarkAllSectionsDirty();
+			return;
+		}
+
+		for (int i = first; i <= last; i++) {
+			int section = isCyclic ? (i < 0 ? i + n : i < n ? i : i - n) : i;
+			if (section >= 0 && section < n) {
+				dirtySections[section] = true;
+				firstDirtySection = std::min(firstDirtySection, section);
+				lastDirtySection = std::max(lastDirtySection, section);
+				CalculateSectionCoefficients(section);
+			}
+		}
+		isDirty = true;
+		revision++;
+	}
+
+	// A control point only influences the sections whose window of four control points includes it
+	void MarkControlPointDirty(int i) {
+		if (Basis::Stride != 1 && isCyclic && controlPoints.size() % Basis::Stride != 0) {
+			MarkAllSectionsDirty(); // the windows do not wrap around evenly
+			return;
+		}
+		int first = i - Basis::Offset - 3, last = i - Basis::Offset;
+		first = first >= 0 ? (first + Basis::Stride - 1) / Basis::Stride : -(-first / Basis::Stride);
+		last = last >= 0 ? last / Basis::Stride : -((-last + Basis::Stride - 1) / Basis::Stride);
+		MarkSectionsDirty(first, last);
+	}
+
+	// The custom orientation of a control point only blends into the forward vectors of the sections that start or end at it,
+	//	but the up vectors are transported from there to the end of the spline
+	void MarkOrientationDirty(int i) {
+		int first = i - Basis::Offset - Basis::SectionEnd, last = i - Basis::Offset - Basis::SectionStart;
+		first = first >= 0 ? (first + Basis::Stride - 1) / Basis::Stride : -1;
+		if (first < 0 || (isCyclic && (Basis::Stride != 1 || last >= GetSectionCount())))
+			first = 0; // the sections around it may wrap around the end of a cyclic spline
+		firstStaleFrameSection = std::min(firstStaleFrameSection, first);
+		revision++;
+	}
+
+	void MarkAllSectionsDirty() {
+		int sections = GetSectionCount();
+		isHierarchyStale = true;
+		dirtySections.assign(sections, true);
+		areAllSectionsDirty = true;
+		sectionOffsets.assign(sections + 1, 0);
+		sectionStartDistances.assign(sections + 1, 0.0f);
+		for (std::vector<float>& bounds : sectionBounds)
+			bounds.assign(sections, 0.0f);
+		staleLevelsOfDetail.assign(sections, true);
+		levelOfDetailIndices.clear();
+		levelOfDetailCompactions++;
+		levelOfDetailFirsts.assign(sections * (LevelOfDetailCount - 1), 0);
+		levelOfDetailCounts.assign(sections * (LevelOfDetailCount - 1), 0);
+		levelOfDetailErrors.assign(sections * (LevelOfDetailCount - 1), 0.0f);
+		usedLevelOfDetailIndices = 0;
+		sectionCoefficients.resize(sections);
+		for (int i = 0; i < sections; i++) {
+			CalculateSectionCoefficients(i);
+		}
+		isDirty = true;
+		revision++;
+	}
+
+	// Keeps the computed sections in step with a control point inserted at index i, by adding an empty section there
+	void InsertSection(int i) {
+		i = i < (int)dirtySections.size() ? i : dirtySections.size();
+		isHierarchyStale = true;
+		sectionOffsets.insert(sectionOffsets.begin() + i, sectionOffsets[i]);
+		sectionStartDistances.insert(sectionStartDistances.begin() + i + 1, sectionStartDistances[i]);
+		firstStaleSectionStart = std::min(firstStaleSectionStart, i);
+		sectionCoefficients.insert(sectionCoefficients.begin() + i, SectionCoefficients());
+		dirtySections.insert(dirtySections.begin() + i, true);
+		firstDirtySection = std::min(firstDirtySection, i);
+		lastDirtySection = std::max(lastDirtySection + 1, i);
+		for (std::vector<float>& bounds : sectionBounds)
+			bounds.insert(bounds.begin() + i, 0.0f);
+		staleLevelsOfDetail.insert(staleLevelsOfDetail.begin() + i, true);
+		int slot = i * (LevelOfDetailCount - 1);
+		levelOfDetailFirsts.insert(levelOfDetailFirsts.begin() + slot, LevelOfDetailCount - 1, 0);
+		levelOfDetailCounts.insert(levelOfDetailCounts.begin() + slot, LevelOfDetailCount - 1, 0);
+		levelOfDetailErrors.insert(levelOfDetailErrors.begin() + slot, LevelOfDetailCount - 1, 0.0f);
+	}
+
+	// Keeps the computed sections in step with the control point erased at index i, by dropping the section there with its points
+	void EraseSection(int i) {
+		i = i < (int)dirtySections.size() ? i : dirtySections.size() - 1;
+		isHierarchyStale = true;
+		unsigned int first = sectionOffsets[i], samples = sectionOffsets[i + 1] - first;
+		length -= GetSectionLength(i);
+		paddingCount -= samples - GetSampleCount(i);
+		splinePoints.erase(splinePoints.begin() + first, splinePoints.begin() + first + samples);
+		splineParameters.erase(splineParameters.begin() + first, splineParameters.begin() + first + samples);
+		splineDistances.erase(splineDistances.begin() + first, splineDistances.begin() + first + samples);
+		sectionOffsets.erase(sectionOffsets.begin() + i);
+		for (unsigned int k = i; k < sectionOffsets.size(); k++)
+			sectionOffsets[k] -= samples;
+		sectionStartDistances.erase(sectionStartDistances.begin() + i + 1);
+		firstStaleSectionStart = std::min(firstStaleSectionStart, i);
+		firstStaleFrameSection = std::min(firstStaleFrameSection, i);
+		sectionCoefficients.erase(sectionCoefficients.begin() + i);
+		dirtySections.erase(dirtySections.begin() + i);
+		firstDirtySection = firstDirtySection > 0 ? firstDirtySection - 1 : 0;
+		for (std::vector<float>& bounds : sectionBounds)
+			bounds.erase(bounds.begin() + i);
+		MarkLevelsOfDetailStale(i);
+		staleLevelsOfDetail.erase(staleLevelsOfDetail.begin() + i);
+		int slot = i * (LevelOfDetailCount - 1);
+		levelOfDetailFirsts.erase(levelOfDetailFirsts.begin() + slot, levelOfDetailFirsts.begin() + slot + LevelOfDetailCount - 1);
+		levelOfDetailCounts.erase(levelOfDetailCounts.begin() + slot, levelOfDetailCounts.begin() + slot + LevelOfDetailCount - 1);
+		levelOfDetailErrors.erase(levelOfDetailErrors.begin() + slot, levelOfDetailErrors.begin() + slot + LevelOfDetailCount - 1);
+	}
+
+	// Leaves the levels of detail of the i-th section to be simplified again on the next request, and their indices unused
+	void MarkLevelsOfDetailStale(int i) const {
+		if (staleLevelsOfDetail[i])
+			return;
+		staleLevelsOfDetail[i] = true;
+		int slot = i * (LevelOfDetailCount - 1);
+		for (int level = 0; level < LevelOfDetailCount - 1; level++)
+			usedLevelOfDetailIndices -= levelOfDetailCounts[slot + level];
+	}
+
+	// Simplifies the computed points of the i-th section into its coarser levels of detail, if they changed since, with tolerances
+	//	relative to the size of the section, each level only keeping points kept by the previous one.
+	// The indices are appended after those of all sections, so the unused ones are compacted first once they outnumber those in use.
+	void UpdateLevelsOfDetail(int i) const {
+		if (!staleLevelsOfDetail[i])
+			return;
+		if (levelOfDetailIndices.size() > 2 * usedLevelOfDetailIndices)
+			CompactLevelsOfDetail();
+		staleLevelsOfDetail[i] = false;
+
+		const glm::vec3 extent(sectionBounds[3][i], sectionBounds[4][i], sectionBounds[5][i]);
+		float tolerance = 2.0f * glm::length(extent) / (1 << (2 * (LevelOfDetailCount - 1)));
+		unsigned int offset = sectionOffsets[i], candidatesFirst = 0, candidatesCount = 0;
+		for (int level = 1; level < LevelOfDetailCount; level++, tolerance *= 4.0f) {
+			int slot = i * (LevelOfDetailCount - 1) + level - 1;
+			levelOfDetailFirsts[slot] = levelOfDetailIndices.size();
+			levelOfDetailErrors[slot] = SimplifyPoints(&splinePoints[offset], GetSampleCount(i), tolerance,
+				levelOfDetailIndices, candidatesFirst, candidatesCount);
+			levelOfDetailCounts[slot] = levelOfDetailIndices.size() - levelOfDetailFirsts[slot];
+			usedLevelOfDetailIndices += levelOfDetailCounts[slot];
+			candidatesFirst = levelOfDetailFirsts[slot];
+			candidatesCount = levelOfDetailCounts[slot];
+		}
+	}
+
+	// Moves the indices of the levels of detail in use to the start, dropping those of the sections that changed since
+	void CompactLevelsOfDetail() const {
+		spareLevelOfDetailIndices.clear();
+		for (unsigned int slot = 0; slot < levelOfDetailFirsts.size(); slot++) {
+			if (staleLevelsOfDetail[slot / (LevelOfDetailCount - 1)])
+				continue;
+			unsigned int first = levelOfDetailFirsts[slot];
+			levelOfDetailFirsts[slot] = spareLevelOfDetailIndices.size();
+			spareLevelOfDetailIndices.insert(spareLevelOfDetailIndices.end(), levelOfDetailIndices.begin() + first,
+				levelOfDetailIndices.begin() + first + levelOfDetailCounts[slot]);
+		}
+		levelOfDetailIndices.swap(spareLevelOfDetailIndices);
+		levelOfDetailCompactions++;
+	}
+
+	// Recomputes the points and the length if the spline changed since they were last computed.
+	// Edits only mark the spline as dirty, so any number of them are coalesced into a single recompute on the next read.
+	void UpdateSplinePoints() const {
+		if (isDirty)
+			CalculateSplinePoints();
+	}
+
+	// Recomputes the frames from the first section whose points or orientations changed since they were last computed, once the points are up to date
+	void UpdateSplineFrames() const {
+		if (firstStaleFrameSection < GetSectionCount())
+			CalculateSplineFrames();
+	}
+
+	// Recomputes the points of the dirty sections only, and the length.
+	// Each dirty section is computed on its own and written over its previous points in place. A section that needs more points than it had
+	//	shifts those of the sections after it, leaving some room to spare, and one that needs fewer repeats its end point to fill the rest,
+	//	so an edit only moves the points of the rest of the spline once in a while. The length is updated by the difference of the sections.
+	// When all sections are dirty, or once the repeated points outnumber the others, the points of all sections are laid out one after the other again.
+	void CalculateSplinePoints() const {
+		int sections = GetSectionCount();
+		isDirty = false;
+
+		unsigned int refinementPoint = 0;
+		if (sampleBudget > 0) {
+			dirtySections.assign(sections, true);
+			areAllSectionsDirty = true;
+			CalculateBudgetedSubdivision(sections);
+		}
+
+		// Whether the points of any section move, so views of the spline refresh all of them instead of the rewritten sections
+		bool isLaidOut = areAllSectionsDirty || isHierarchyStale;
+		if (areAllSectionsDirty) {
+			splinePoints.clear();
+			splineParameters.clear();
+			splineDistances.clear();
+			paddingCount = 0;
+			for (int i = 0; i < sections; i++) {
+				CalculateSectionPoints(i, refinementPoint);
+				sectionOffsets[i] = splinePoints.size();
+				paddingCount += AppendSectionPoints(newSectionPoints.data(), newSectionParameters.data(), newSectionDistances.data(),
+					newSectionPoints.size(), splinePoints, splineParameters, splineDistances);
+			}
+			sectionOffsets[sections] = splinePoints.size();
+			firstStaleSectionStart = 0;
+			UpdateSectionStartDistances();
+		}
+		else {
+			for (int i = firstDirtySection; i <= lastDirtySection && i < sections; i++) {
+				if (!dirtySections[i])
+					continue;
+				CalculateSectionPoints(i, refinementPoint);
+				isLaidOut = WriteSectionPoints(i) || isLaidOut;
+				rewrittenSections.push_back({ revision, (unsigned int)i });
+			}
+			if (2 * paddingCount > splinePoints.size()) {
+				CompactSplinePoints();
+				isLaidOut = true;
+			}
+		}
+		areAllSectionsDirty = false;
+		firstDirtySection = INT_MAX;
+		lastDirtySection = -1;
+		if (isLaidOut || rewrittenSections.size() > std::min((size_t)sections, MaxKeptChanges))
+			ForgetChanges();
+
+		// The sections were added, removed or shifted, so their leaves are rebuilt instead of refitted
+		if (isHierarchyStale) {
+			sectionHierarchy.Build(sectionBounds);
+			isHierarchyStale = false;
+		}
+	}
+
+	// Computes the points of the i-th section into the new section buffers, with their parameters and arc lengths, and its bounding box
+	void CalculateSectionPoints(int i, unsigned int& refinementPoint) const {
+		dirtySections[i] = false;
+		MarkLevelsOfDetailStale(i);
+		firstStaleFrameSection = std::min(firstStaleFrameSection, i);
+
+		newSectionPoints.clear();
+		newSectionParameters.clear();
+		newSectionDistances.clear();
+		glm::vec3 x0 = GetPoint(0.0f, i);
+		glm::vec3 x1 = GetPoint(1.0f, i);
+		newSectionPoints.push_back(x0);
+		newSectionParameters.push_back(0.0f);
+		if (sampleBudget > 0) {
+			for (; refinementPoint < refinementPoints.size() && refinementPoints[refinementPoint].i == i; refinementPoint++) {
+				newSectionPoints.push_back(refinementPoints[refinementPoint].x);
+				newSectionParameters.push_back(refinementPoints[refinementPoint].t);
+			}
+		}
+		else
+			CalculateAdaptiveSubdivision(i, x0, x1, GetTangent(0.0f, i), GetTangent(1.0f, i), newSectionPoints, newSectionParameters);
+		newSectionPoints.push_back(x1);
+		newSectionParameters.push_back(1.0f);
+
+		// Accumulate the arc length of each sample from the start of the section, integrated between consecutive samples
+		//	with their share of the tolerance, so the length of the section does not depend on how finely it is sampled
+		newSectionDistances.push_back(0.0f);
+		for (unsigned int j = 1; j < newSectionPoints.size(); j++) {
+			float t0 = newSectionParameters[j - 1], t1 = newSectionParameters[j];
+			newSectionDistances.push_back(newSectionDistances[j - 1] + CalculateArcLength(t0, t1, i, arcLengthTolerance * (t1 - t0)));
+		}
+
+		CalculateSectionBounds(i, newSectionPoints.data(), newSectionPoints.size());
+	}
+
+	// Sets the bounding box of the i-th section to that of its count computed points, which is all that gets drawn of it.
+	// It is tighter than the convex hull of the control points, which Catmull-Rom and Hermite sections do not even stay within
+	void CalculateSectionBounds(int i, const glm::vec3* points, unsigned int count) const {
+		glm::vec3 minimum = points[0], maximum = points[0];
+		for (unsigned int j = 1; j < count; j++) {
+			minimum = glm::min(minimum, points[j]);
+			maximum = glm::max(maximum, points[j]);
+		}
+		for (int axis = 0; axis < 3; axis++) {
+			sectionBounds[axis][i] = (minimum[axis] + maximum[axis]) * 0.5f;
+			sectionBounds[3 + axis][i] = (maximum[axis] - minimum[axis]) * 0.5f;
+		}
+		if (!isHierarchyStale)
+			sectionHierarchy.Refit(i, sectionBounds);
+	}
+
+	// Lays out the points baked in the file as the computed points of all sections, as if they had just been computed,
+	//	leaving only their levels of detail and frames to be computed on request
+	void LoadSplinePoints(const SplineFileView& file) {
+		int sections = GetSectionCount();
+		const unsigned int* offsets = file.SectionOffsets();
+		splinePoints.clear();
+		splineParameters.clear();
+		splineDistances.clear();
+		paddingCount = 0;
+		for (int i = 0; i < sections; i++) {
+			unsigned int first = offsets[i], count = CountSamples(file.SplineParameters() + first, offsets[i + 1] - first);
+			sectionOffsets[i] = splinePoints.size();
+			paddingCount += AppendSectionPoints(file.SplinePoints() + first, file.SplineParameters() + first, file.SplineDistances() + first, count,
+				splinePoints, splineParameters, splineDistances);
+			CalculateSectionBounds(i, file.SplinePoints() + first, count);
+		}
+		sectionOffsets[sections] = splinePoints.size();
+
+		dirtySections.assign(sections, false);
+		areAllSectionsDirty = false;
+		firstDirtySection = INT_MAX;
+		lastDirtySection = -1;
+		isDirty = false;
+		firstStaleSectionStart = 0;
+		UpdateSectionStartDistances();
+		firstStaleFrameSection = 0;
+		sectionHierarchy.Build(sectionBounds);
+		isHierarchyStale = false;
+		ForgetChanges();
+	}
+
+	// Writes the new points of the i-th section over its previous ones, shifting those after it if they do not fit.
+	// Returns whether it shifted them.
+	bool WriteSectionPoints(int i) const {
+		unsigned int first = sectionOffsets[i], slot = sectionOffsets[i + 1] - first, count = newSectionPoints.size();
+		length += newSectionDistances.back() - GetSectionLength(i);
+		paddingCount -= slot - GetSampleCount(i);
+		bool isGrown = slot < count;
+		if (isGrown) {
+			unsigned int grown = GetSectionRoom(count);
+			splinePoints.insert(splinePoints.begin() + first + slot, grown - slot, glm::vec3());
+			splineParameters.insert(splineParameters.begin() + first + slot, grown - slot, 0.0f);
+			splineDistances.insert(splineDistances.begin() + first + slot, grown - slot, 0.0f);
+			for (unsigned int k = i + 1; k < sectionOffsets.size(); k++)
+				sectionOffsets[k] += grown - slot;
+			slot = grown;
+		}
+		paddingCount += slot - count;
+
+		std::copy(newSectionPoints.begin(), newSectionPoints.end(), splinePoints.begin() + first);
+		std::copy(newSectionParameters.begin(), newSectionParameters.end(), splineParameters.begin() + first);
+		std::copy(newSectionDistances.begin(), newSectionDistances.end(), splineDistances.begin() + first);
+		std::fill(splinePoints.begin() + first + count, splinePoints.begin() + first + slot, newSectionPoints.back());
+		std::fill(splineParameters.begin() + first + count, splineParameters.begin() + first + slot, 1.0f);
+		std::fill(splineDistances.begin() + first + count, splineDistances.begin() + first + slot, newSectionDistances.back());
+		firstStaleSectionStart = std::min(firstStaleSectionStart, i);
+		return isGrown;
+	}
+
+	// Lays out the points of all sections one after the other again, each with the room it would be given if it was just computed,
+	//	dropping the rest of the points that repeat their end points
+	void CompactSplinePoints() const {
+		int sections = GetSectionCount();
+		spareSplinePoints.clear();
+		spareSplineParameters.clear();
+		spareSplineDistances.clear();
+		paddingCount = 0;
+		for (int i = 0; i < sections; i++) {
+			unsigned int first = sectionOffsets[i], count = GetSampleCount(i);
+			sectionOffsets[i] = spareSplinePoints.size();
+			if (sectionOffsets[i] != first)
+				firstStaleFrameSection = std::min(firstStaleFrameSection, i);
+			paddingCount += AppendSectionPoints(&splinePoints[first], &splineParameters[first], &splineDistances[first], count,
+				spareSplinePoints, spareSplineParameters, spareSplineDistances);
+		}
+		sectionOffsets[sections] = spareSplinePoints.size();
+		splinePoints.swap(spareSplinePoints);
+		splineParameters.swap(spareSplineParameters);
+		splineDistances.swap(spareSplineDistances);
+	}
+
+	// The room a section of count computed points is laid out with, so it can take a quarter more before the points after it have to be moved.
+	// The sections of a sample budget are all laid out again on every edit, so they get no more than they need.
+	unsigned int GetSectionRoom(unsigned int count) const { return sampleBudget > 0 ? count : count + count / 4; }
+
+	// Appends the count computed points of a section, with their parameters and arc lengths, and then its end point again to fill the rest of its room.
+	// Returns the number of points appended to fill it.
+	unsigned int AppendSectionPoints(const glm::vec3* points, const float* parameters, const float* distances, unsigned int count,
+		std::vector<glm::vec3>& outPoints, std::vector<float>& outParameters, std::vector<float>& outDistances) const {
+		unsigned int padding = GetSectionRoom(count) - count;
+		outPoints.insert(outPoints.end(), points, points + count);
+		outPoints.insert(outPoints.end(), padding, points[count - 1]);
+		outParameters.insert(outParameters.end(), parameters, parameters + count);
+		outParameters.insert(outParameters.end(), padding, 1.0f);
+		outDistances.insert(outDistances.end(), distances, distances + count);
+		outDistances.insert(outDistances.end(), padding, distances[count - 1]);
+		return padding;
+	}
+
+	// The number of computed points of the i-th section up to its end point, without those repeating it to fill its room
+	unsigned int GetSampleCount(int i) const {
+		return CountSamples(splineParameters.data() + sectionOffsets[i], sectionOffsets[i + 1] - sectionOffsets[i]);
+	}
+
+	// The number of points of a section up to its end point, the first one at t = 1, from the parameters of the points of its whole room
+	static unsigned int CountSamples(const float* parameters, unsigned int room) {
+		unsigned int count = std::lower_bound(parameters, parameters + room, 1.0f) - parameters + 1;
+		return count < room ? count : room;
+	}
+
+	// The arc length of the i-th section, as the distance of its last computed point, or 0 if it has none yet
+	float GetSectionLength(int i) const {
+		return sectionOffsets[i + 1] > sectionOffsets[i] ? splineDistances[sectionOffsets[i + 1] - 1] : 0.0f;
+	}
+
+	// Accumulates the distances at which the sections start again from the first one whose length changed, and the length with them,
+	//	once the points are up to date. The length is kept up to date by each edit, but the table is only needed by the queries by distance.
+	void UpdateSectionStartDistances() const {
+		int sections = GetSectionCount();
+		if (firstStaleSectionStart >= sections)
+			return;
+		for (int i = firstStaleSectionStart; i < sections; i++) {
+			sectionStartDistances[i + 1] = sectionStartDistances[i] + GetSectionLength(i);
+		}
+		length = sectionStartDistances[sections];
+		firstStaleSectionStart = INT_MAX;
+	}
+
+	// Appends to outIndices the indices of a subset of the count points, from the first to the last one,
+	//	such that all the points left out are within tolerance of the lines between those kept.
+	// Only the candidatesCount indices already in outIndices from candidatesFirst can be kept, or any point if there are none.
+	// Each line is extended greedily for as long as it stays within tolerance. Returns the largest distance of a point left out.
+	static float SimplifyPoints(const glm::vec3* points, unsigned int count, float tolerance, std::vector<unsigned int>& outIndices,
+		unsigned int candidatesFirst, unsigned int candidatesCount) {
+		auto candidate = [&](unsigned int k) { return candidatesCount ? outIndices[candidatesFirst + k] : k; };
+		const unsigned int candidates = candidatesCount ? candidatesCount : count;
+
+		const float squaredTolerance = tolerance * tolerance;
+		float squaredError = 0.0f;
+		unsigned int a = 0;
+		outIndices.push_back(candidate(0));
+		while (a + 1 < candidates) {
+			unsigned int b = a + 1;
+			float lineError = 0.0f;
+			for (unsigned int c = a + 2; c < candidates; c++) {
+				const glm::vec3& start = points[candidate(a)];
+				const glm::vec3& end = points[candidate(c)];
+				float candidateError = 0.0f;
+				for (unsigned int j = candidate(a) + 1; j < candidate(c) && candidateError <= squaredTolerance; j++)
+					candidateError = std::max(candidateError, SquaredDistanceToSegment(points[j], start, end));
+				if (candidateError > squaredTolerance)
+					break;
+				b = c;
+				lineError = candidateError;
+			}
+			// a line between consecutive candidates leaves out the points the previous level did
+			if (b == a + 1 && candidatesCount)
+				for (unsigned int j = candidate(a) + 1; j < candidate(b); j++)
+					lineError = std::max(lineError, SquaredDistanceToSegment(points[j], points[candidate(a)], points[candidate(b)]));
+			outIndices.push_back(candidate(b));
+			squaredError = std::max(squaredError, lineError);
+			a = b;
+		}
+		return sqrtf(squaredError);
+	}
+
+	static float SquaredDistanceToSegment(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b) {
+		glm::vec3 ab = b - a;
+		float squaredLength = glm::dot(ab, ab);
+		float f = squaredLength > 0.0f ? glm::clamp(glm::dot(p - a, ab) / squaredLength, 0.0f, 1.0f) : 0.0f;
+		glm::vec3 d = p - (a + ab * f);
+		return glm::dot(d, d);
+	}
+
+	// Recomputes the frames of the computed points from the first stale section, as rotation-minimizing frames transported along the spline.
+	// The forward vector is the tangent blended with the custom orientations, and the up vector is carried over from
+	//	one point to the next by the double reflection method, so it does not flip when the tangent goes vertical.
+	// The frames of the sections before are kept, as the indices of their points did not change either.
+	void CalculateSplineFrames() const {
+		int sections = GetSectionCount();
+		int firstSection = firstStaleFrameSection;
+		firstStaleFrameSection = INT_MAX;
+		splineForwards.resize(splinePoints.size());
+		splineUps.resize(splinePoints.size());
+		frameTwist = 0.0f;
+		if (splinePoints.empty())
+			return;
+
+		for (int i = firstSection; i < sections; i++) {
+			for (unsigned int j = sectionOffsets[i]; j < sectionOffsets[i + 1]; j++) {
+				splineForwards[j] = GetOrientation(splineParameters[j], i);
+			}
+		}
+
+		// Start with the up vector closest to the Y axis, or to the X axis if the spline starts vertical
+		unsigned int first = sectionOffsets[firstSection];
+		glm::vec3 forward = splineForwards[0];
+		if (first == 0) {
+			glm::vec3 up = fabsf(forward.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+			splineUps[0] = glm::normalize(up - glm::dot(up, forward) * forward);
+			first = 1;
+		}
+		for (unsigned int j = first; j < splinePoints.size(); j++) {
+			splineUps[j] = SplineSection::TransportUp(splinePoints[j - 1], splinePoints[j], splineForwards[j - 1], splineForwards[j], splineUps[j - 1]);
+		}
+
+		// A cyclic spline ends where it starts, but the transported up vector comes back twisted around the forward vector.
+		// The twist is spread along the spline by its arc length when the frames are read, so they match again at the end.
+		if (isCyclic) {
+			glm::vec3 end = splineUps.back();
+			frameTwist = atan2f(glm::dot(glm::cross(end, splineUps[0]), forward), glm::dot(end, splineUps[0]));
+		}
+	}
+
+	// The up vector of the k-th computed point, of the i-th section, turned by its share of the twist of a cyclic spline
+	glm::vec3 GetTwistedUp(unsigned int k, int i) const {
+		if (frameTwist == 0.0f || length <= 0.0f)
+			return splineUps[k];
+		float angle = frameTwist * (sectionStartDistances[i] + splineDistances[k]) / length;
+		return cosf(angle) * splineUps[k] + sinf(angle) * glm::cross(splineForwards[k], splineUps[k]);
+	}
+
+	// The control points that define the spline
+	std::vector<glm::vec3> controlPoints;
+
+	// The defined orientations for each control point
+	std::vector<glm::vec3> orientations;
+
+	// The computed points that draw the spline, stored contiguously for all sections
+	mutable std::vector<glm::vec3> splinePoints;
+
+	// The value of the parameter t [0, 1] of each computed point, local to its section
+	mutable std::vector<float> splineParameters;
+
+	// The arc-length table: the distance of each computed point from the start of its section
+	mutable std::vector<float> splineDistances;
+
+	// The index of the first computed point of each section, with the total number of points at the end
+	mutable std::vector<unsigned int> sectionOffsets;
+
+	// The number of computed points that only repeat the end point of their section, to fill the room it is laid out with
+	mutable unsigned int paddingCount = 0;
+
+	// The buffers into which the computed points are laid out again once compacted, kept to reuse their memory
+	mutable std::vector<glm::vec3> spareSplinePoints;
+	mutable std::vector<float> spareSplineParameters;
+	mutable std::vector<float> spareSplineDistances;
+
+	// The computed points of the section being recomputed, with their parameters and arc lengths, before they are written in place,
+	//	kept to reuse their memory
+	mutable std::vector<glm::vec3> newSectionPoints;
+	mutable std::vector<float> newSectionParameters;
+	mutable std::vector<float> newSectionDistances;
+
+	// The rotation-minimizing frame of each computed point: its forward and up vectors, the latter before the twist of a cyclic spline
+	mutable std::vector<glm::vec3> splineForwards;
+	mutable std::vector<glm::vec3> splineUps;
+
+	// The bounding box of the computed points of each section, as the x, y, z of their centers and then of their half extents
+	mutable std::vector<float> sectionBounds[6];
+
+	// The levels of detail of each section other than 0: the indices into the computed points of the section for all sections and levels,
+	//	the first one and the number of them of each section and level, and the largest distance of the points left out.
+	// The indices of the sections whose levels are stale, as their points changed since, are left unused until they are compacted
+	//	into the spare buffer, and the number of those in use is kept to know when.
+	mutable std::vector<unsigned int> levelOfDetailIndices;
+	mutable std::vector<unsigned int> levelOfDetailFirsts;
+	mutable std::vector<unsigned int> levelOfDetailCounts;
+	mutable std::vector<float> levelOfDetailErrors;
+	mutable std::vector<bool> staleLevelsOfDetail;
+	mutable unsigned int usedLevelOfDetailIndices = 0;
+	mutable std::vector<unsigned int> spareLevelOfDetailIndices;
+
+	// The number of times the indices of the levels of detail were compacted or cleared, so those appended since are no longer past the end
+	mutable unsigned int levelOfDetailCompactions = 0;
+
+	// The hierarchy of the bounding boxes of the sections, for the closest point queries,
+	//	and whether it has to be built again as the sections no longer match its leaves
+	mutable SectionHierarchy sectionHierarchy;
+	mutable bool isHierarchyStale = true;
+
+	// The hierarchy of the control points, for picking them, and whether it has to be built again
+	//	as control points were added or removed since
+	mutable SectionHierarchy controlPointHierarchy;
+	mutable bool isControlPointHierarchyStale = true;
+
+	// The distance along the spline at which each section starts, with the total length at the end,
+	//	and the first section whose start is stale, or INT_MAX if none is
+	mutable std::vector<float> sectionStartDistances;
+	mutable int firstStaleSectionStart = INT_MAX;
+
+	// The polynomial coefficients of each section, recomputed along with its points
+	std::vector<SectionCoefficients> sectionCoefficients;
+
+	// Whether each section needs to be recomputed since the last CalculateSplinePoints, the range of those that may,
+	//	and whether they all do, so their points are laid out from scratch
+	mutable std::vector<bool> dirtySections;
+	mutable int firstDirtySection = INT_MAX;
+	mutable int lastDirtySection = -1;
+	mutable bool areAllSectionsDirty = false;
+
+	// Whether any section needs to be recomputed. The points and the length are computed lazily on the first read after an edit.
+	mutable bool isDirty = false;
+
+	// The first section whose frames need to be recomputed, after its points or the custom orientations changed, or INT_MAX if none does
+	mutable int firstStaleFrameSection = INT_MAX;
+
+	// The angle the transported up vectors of a cyclic spline come back twisted by at its end, spread along it as its frames are read
+	mutable float frameTwist = 0.0f;
+
+	// The number of changes made to the spline
+	unsigned int revision = 0;
+
+	// The sections whose points were rewritten in place and the control points moved or turned, with the revisions they changed at,
+	//	since the revision the points were last laid out again at, for GetChangesSince
+	mutable std::vector<Change> rewrittenSections;
+	mutable std::vector<Change> changedControlPoints;
+	mutable unsigned int layoutRevision = 0;
+
+	// The pending intervals of the adaptive subdivision, kept to reuse its memory
+	mutable std::vector<SubdivisionInterval> subdivisionStack;
+
+	// The pending intervals and the computed points of the budgeted subdivision, kept to reuse their memory
+	mutable std::vector<RefinementInterval> refinementIntervals;
+	mutable std::vector<RefinementKey> refinementQueue;
+	mutable std::vector<RefinementPoint> refinementPoints;
+
+	// The number of computed points for the whole spline, or 0 to sample each section adaptively
+	unsigned int sampleBudget = 0;
+
+	// Index to the currently selected control point.
+	// Transformations will be performed to this point.
+	unsigned int selectedControlPoint;
+
+	// This parameter controls the level of detail of the curve in adaptive sampling,
+	//	in the maximum angle difference allowed between tangents
+	float adaptiveSamplingDetailAngleThreshold;
+
+	// This parameter controls the level of detail of the curve in adaptive sampling,
+	//	in the maximum distance allowed between a point and the curve.
+	float adaptiveSamplingDetailDistanceThreshold;
+
+	// This parameter controls the maximum depth of the recursion in the adaptive sampling.
+	// This shouldn't be used to control quality of the curve.
+	// It is recommended to keep its default value, unless the program crashes for memory allocation issues.
+	float maximumSamplingDetail;
+
+	// Whether to explicitly draw the points that are used to render the spline
+	bool drawDebugPoints;
+
+	// Whether this spline is cyclic or clamped.
+	bool isCyclic = false;
+
+	// The largest error allowed in the arc length of each section
+	float arcLengthTolerance = 0.0001f;
+
+	// The length of the spline, as the sum of the arc lengths of its sections
+	mutable float length = 0.0f;
+};
+
+// The instantiations for the provided bases are compiled once, in SplineCore.cpp
+extern template class Spline<UniformBSplineBasis>;
+extern template class Spline<CatmullRomBasis>;
+extern template class Spline<BezierBasis>;
+extern template class Spline<HermiteBasis>;
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef SPLINE_BASIS_H
+#define SPLINE_BASIS_H
+
+// The basis policies of Spline. Each one defines at compile time how a section of the spline is built
+//	from a window of 4 consecutive control points:
+//	- Matrix: the weights of the 4 control points of the window in each coefficient of the section
+//	  as a polynomial in the parameter t [0, 1], one row per power of t: a + bt + ct^2 + dt^3.
+//	- Stride and Offset: the window of the i-th section starts at control point Stride * i + Offset.
+//	- SectionStart and SectionEnd: the control points of the window the section goes from and to.
+//	- SectionCount: the number of sections of a spline with the given number of control points.
+//	- IsInterpolating: whether a clamped spline already passes through its first and last control points.
+//	- Id: identifies the basis in spline files (see SplineFile.h), so it must never change.
+
+// Uniform cubic B-spline: smooth, but only approximates its control points.
+struct UniformBSplineBasis
+{
+	static constexpr float Matrix[4][4] = {
+		{  1.0f / 6.0f,  4.0f / 6.0f,  1.0f / 6.0f, 0.0f },
+		{ -3.0f / 6.0f,  0.0f,         3.0f / 6.0f, 0.0f },
+		{  3.0f / 6.0f, -6.0f / 6.0f,  3.0f / 6.0f, 0.0f },
+		{ -1.0f / 6.0f,  3.0f / 6.0f, -3.0f / 6.0f, 1.0f / 6.0f }
+	};
+	static constexpr int Stride = 1;
+	static constexpr int Offset = -1;
+	static constexpr int SectionStart = 1;
+	static constexpr int SectionEnd = 2;
+	static constexpr bool IsInterpolating = false;
+	static constexpr unsigned int Id = 0;
+
+	static constexpr int SectionCount(int controlPoints, bool isCyclic) { return controlPoints - !isCyclic; }
+};
+
+// Catmull-Rom spline: passes through all its control points.
+struct CatmullRomBasis
+{
+	static constexpr float Matrix[4][4] = {
+		{  0.0f,  1.0f,  0.0f,  0.0f },
+		{ -0.5f,  0.0f,  0.5f,  0.0f },
+		{  1.0f, -2.5f,  2.0f, -0.5f },
+		{ -0.5f,  1.5f, -1.5f,  0.5f }
+	};
+	static constexpr int Stride = 1;
+	static constexpr int Offset = -1;
+	static constexpr int SectionStart = 1;
+	static constexpr int SectionEnd = 2;
+	static constexpr bool IsInterpolating = true;
+	static constexpr unsigned int Id = 1;
+
+	static constexpr int SectionCount(int controlPoints, bool isCyclic) { return controlPoints - !isCyclic; }
+};
+
+// Cubic Bezier spline: every 3 control points, the curve passes through one, and the two in between shape it.
+struct BezierBasis
+{
+	static constexpr float Matrix[4][4] = {
+		{  1.0f,  0.0f,  0.0f, 0.0f },
+		{ -3.0f,  3.0f,  0.0f, 0.0f },
+		{  3.0f, -6.0f,  3.0f, 0.0f },
+		{ -1.0f,  3.0f, -3.0f, 1.0f }
+	};
+	static constexpr int Stride = 3;
+	static constexpr int Offset = 0;
+	static constexpr int SectionStart = 0;
+	static constexpr int SectionEnd = 3;
+	static constexpr bool IsInterpolating = true;
+	static constexpr unsigned int Id = 2;
+
+	static constexpr int SectionCount(int controlPoints, bool isCyclic) { return isCyclic ? controlPoints / 3 : (controlPoints - 1) / 3; }
+};
+
+// Cubic Hermite spline: the control points alternate between the positions the curve passes through and its tangents at them.
+struct HermiteBasis
+{
+	static constexpr float Matrix[4][4] = {
+		{  1.0f,  0.0f,  0.0f,  0.0f },
+		{  0.0f,  1.0f,  0.0f,  0.0f },
+		{ -3.0f, -2.0f,  3.0f, -1.0f },
+		{  2.0f,  1.0f, -2.0f,  1.0f }
+	};
+	static constexpr int Stride = 2;
+	static constexpr int Offset = 0;
+	static constexpr int SectionStart = 0;
+	static constexpr int SectionEnd = 2;
+	static constexpr bool IsInterpolating = true;
+	static constexpr unsigned int Id = 3;
+
+	static constexpr int SectionCount(int controlPoints, bool isCyclic) { return isCyclic ? controlPoints / 2 : (controlPoints - 2) / 2; }
+};
+
+// The weights of the 4 control points of the window in each coefficient of the first derivative of a section,
+//	one row per power of t: da + db t + dc t^2
+template <typename Basis>
+struct SplineBasisDerivative
+{
+	static constexpr float Matrix[3][4] = {
+		{ Basis::Matrix[1][0], Basis::Matrix[1][1], Basis::Matrix[1][2], Basis::Matrix[1][3] },
+		{ 2.0f * Basis::Matrix[2][0], 2.0f * Basis::Matrix[2][1], 2.0f * Basis::Matrix[2][2], 2.0f * Basis::Matrix[2][3] },
+		{ 3.0f * Basis::Matrix[3][0], 3.0f * Basis::Matrix[3][1], 3.0f * Basis::Matrix[3][2], 3.0f * Basis::Matrix[3][3] }
+	};
+};
+
+#endif // !SPLINE_BASIS_H
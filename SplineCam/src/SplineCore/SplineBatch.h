@@ -0,0 +1,254 @@
+#ifndef SPLINE_BATCH_H
+#define SPLINE_BATCH_H
+
+#include <cstddef>
+#include <math.h>
+
+#if defined(__AVX__)
+#define SPLINE_BATCH_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPLINE_BATCH_SSE
+#include <emmintrin.h>
+#endif
+
+// Caller-provided structure of arrays that receives the results of a batch evaluation.
+// Each array must hold as many elements as parameters are evaluated. Leave any of them null to skip that output.
+struct SplineBatchOutput
+{
+	// The points of the spline
+	float* x = nullptr;
+	float* y = nullptr;
+	float* z = nullptr;
+
+	// The normalized tangents of the curve (without the custom orientations)
+	float* tangentX = nullptr;
+	float* tangentY = nullptr;
+	float* tangentZ = nullptr;
+
+	// The (non-normalized) second derivatives of the curve
+	float* secondDerivativeX = nullptr;
+	float* secondDerivativeY = nullptr;
+	float* secondDerivativeZ = nullptr;
+};
+
+// Kernels that evaluate many values of the parameter t [0, 1] of a spline at once.
+// The spline is given as its sections in the polynomial basis a + bt + ct^2 + dt^3,
+//	with the 12 floats of a, b, c, d contiguous at the start of each section, stride floats apart.
+// The AVX or SSE kernel is picked at compile time depending on the target instruction set, with a scalar fallback.
+class SplineBatchKernels
+{
+public:
+
+	static void Evaluate(const float* coefficients, int stride, int sections,
+		const float* t, size_t count, const SplineBatchOutput& output)
+	{
+		if (sections <= 0)
+			return;
+
+		size_t k = 0;
+#if defined(SPLINE_BATCH_AVX) || defined(SPLINE_BATCH_SSE)
+		// Without derivatives, there is less to compute than to transpose, so the points have a kernel of their own
+		if (!output.tangentX && !output.secondDerivativeX) {
+			if (!output.x)
+				return;
+			for (; k + 4 <= count; k += 4)
+				EvaluatePointsSSE(coefficients, stride, sections, t, k, output);
+			for (; k < count; k++)
+				EvaluateScalar(coefficients, stride, sections, t, k, output);
+			return;
+		}
+#endif
+#if defined(SPLINE_BATCH_AVX)
+		for (; k + 8 <= count; k += 8)
+			EvaluateAVX(coefficients, stride, sections, t, k, output);
+#endif
+#if defined(SPLINE_BATCH_AVX) || defined(SPLINE_BATCH_SSE)
+		for (; k + 4 <= count; k += 4)
+			EvaluateSSE(coefficients, stride, sections, t, k, output);
+#endif
+		for (; k < count; k++)
+			EvaluateScalar(coefficients, stride, sections, t, k, output);
+	}
+
+protected:
+
+	static void EvaluateScalar(const float* coefficients, int stride, int sections,
+		const float* t, size_t k, const SplineBatchOutput& output)
+	{
+		float* const points[3] = { output.x, output.y, output.z };
+		float* const tangents[3] = { output.tangentX, output.tangentY, output.tangentZ };
+		float* const secondDerivatives[3] = { output.secondDerivativeX, output.secondDerivativeY, output.secondDerivativeZ };
+
+		// Map the parameter t [0, 1] of the whole spline to its section, as Spline::GetPoint(t) does
+		float s = t[k] < 0 ? 0 : t[k] > 1 ? 1 : t[k];
+		s *= sections;
+		int i = (int)s;
+		i = i < sections ? i : sections - 1;
+		s -= i;
+
+		const float* c = coefficients + (size_t)i * stride;
+		for (int axis = 0; axis < 3; axis++) {
+			float a = c[axis], b = c[3 + axis], c2 = c[6 + axis], d = c[9 + axis];
+			float point = a + s * (b + s * (c2 + s * d));
+			float derivative = b + s * (2.0f * c2 + s * 3.0f * d);
+			float secondDerivative = 2.0f * c2 + s * 6.0f * d;
+
+			if (output.x)
+				points[axis][k] = point;
+			if (output.tangentX)
+				tangents[axis][k] = derivative;
+			if (output.secondDerivativeX)
+				secondDerivatives[axis][k] = secondDerivative;
+		}
+
+		if (output.tangentX) {
+			float x = output.tangentX[k], y = output.tangentY[k], z = output.tangentZ[k];
+			float inverseLength = 1.0f / sqrtf(x * x + y * y + z * z);
+			output.tangentX[k] = x * inverseLength;
+			output.tangentY[k] = y * inverseLength;
+			output.tangentZ[k] = z * inverseLength;
+		}
+	}
+
+#if defined(SPLINE_BATCH_AVX) || defined(SPLINE_BATCH_SSE)
+	// Loads a, b, c, d of the sections of 4 lanes, transposed so each register holds one component of the 4 lanes
+	static void LoadCoefficientsSSE(const float* coefficients, int stride, const int section[4], __m128 component[12])
+	{
+		for (int group = 0; group < 3; group++) {
+			__m128 row0 = _mm_loadu_ps(coefficients + (size_t)section[0] * stride + group * 4);
+			__m128 row1 = _mm_loadu_ps(coefficients + (size_t)section[1] * stride + group * 4);
+			__m128 row2 = _mm_loadu_ps(coefficients + (size_t)section[2] * stride + group * 4);
+			__m128 row3 = _mm_loadu_ps(coefficients + (size_t)section[3] * stride + group * 4);
+			_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+			component[group * 4 + 0] = row0;
+			component[group * 4 + 1] = row1;
+			component[group * 4 + 2] = row2;
+			component[group * 4 + 3] = row3;
+		}
+	}
+
+	// Evaluates the points of 4 lanes, each on its own section with a, b, c, d loaded as they are, x, y, z and one more float,
+	//	so only the 4 points are transposed at the end, instead of the 12 components of the coefficients at the start
+	static void EvaluatePointsSSE(const float* coefficients, int stride, int sections,
+		const float* t, size_t k, const SplineBatchOutput& output)
+	{
+		__m128 s = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(t + k), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		s = _mm_mul_ps(s, _mm_set1_ps((float)sections));
+		__m128 i = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(s)), _mm_set1_ps((float)(sections - 1)));
+		s = _mm_sub_ps(s, i);
+
+		int section[4];
+		_mm_storeu_si128((__m128i*)section, _mm_cvttps_epi32(i));
+
+		const __m128 lanes[4] = { _mm_shuffle_ps(s, s, 0x00), _mm_shuffle_ps(s, s, 0x55), _mm_shuffle_ps(s, s, 0xAA), _mm_shuffle_ps(s, s, 0xFF) };
+		__m128 point[4];
+		for (int lane = 0; lane < 4; lane++) {
+			const float* c = coefficients + (size_t)section[lane] * stride;
+			// d is loaded from the float before it and shifted down, so nothing past the 12 floats of the section is read
+			__m128 a = _mm_loadu_ps(c), b = _mm_loadu_ps(c + 3), c2 = _mm_loadu_ps(c + 6);
+			__m128 d = _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(_mm_loadu_ps(c + 8)), 4));
+			__m128 u = lanes[lane];
+			point[lane] = _mm_add_ps(a, _mm_mul_ps(u, _mm_add_ps(b, _mm_mul_ps(u, _mm_add_ps(c2, _mm_mul_ps(u, d))))));
+		}
+		_MM_TRANSPOSE4_PS(point[0], point[1], point[2], point[3]);
+		_mm_storeu_ps(output.x + k, point[0]);
+		_mm_storeu_ps(output.y + k, point[1]);
+		_mm_storeu_ps(output.z + k, point[2]);
+	}
+
+	static void EvaluateSSE(const float* coefficients, int stride, int sections,
+		const float* t, size_t k, const SplineBatchOutput& output)
+	{
+		float* const points[3] = { output.x, output.y, output.z };
+		float* const tangents[3] = { output.tangentX, output.tangentY, output.tangentZ };
+		float* const secondDerivatives[3] = { output.secondDerivativeX, output.secondDerivativeY, output.secondDerivativeZ };
+
+		__m128 s = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(t + k), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		s = _mm_mul_ps(s, _mm_set1_ps((float)sections));
+		__m128 i = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(s)), _mm_set1_ps((float)(sections - 1)));
+		s = _mm_sub_ps(s, i);
+
+		int section[4];
+		_mm_storeu_si128((__m128i*)section, _mm_cvttps_epi32(i));
+
+		__m128 component[12];
+		LoadCoefficientsSSE(coefficients, stride, section, component);
+
+		const __m128 two = _mm_set1_ps(2.0f), three = _mm_set1_ps(3.0f), six = _mm_set1_ps(6.0f);
+		__m128 derivative[3];
+		for (int axis = 0; axis < 3; axis++) {
+			__m128 a = component[axis], b = component[3 + axis], c = component[6 + axis], d = component[9 + axis];
+			if (output.x) {
+				__m128 point = _mm_add_ps(a, _mm_mul_ps(s, _mm_add_ps(b, _mm_mul_ps(s, _mm_add_ps(c, _mm_mul_ps(s, d))))));
+				_mm_storeu_ps(points[axis] + k, point);
+			}
+			if (output.tangentX)
+				derivative[axis] = _mm_add_ps(b, _mm_mul_ps(s, _mm_add_ps(_mm_mul_ps(two, c), _mm_mul_ps(s, _mm_mul_ps(three, d)))));
+			if (output.secondDerivativeX) {
+				__m128 secondDerivative = _mm_add_ps(_mm_mul_ps(two, c), _mm_mul_ps(s, _mm_mul_ps(six, d)));
+				_mm_storeu_ps(secondDerivatives[axis] + k, secondDerivative);
+			}
+		}
+
+		if (output.tangentX) {
+			__m128 squaredLength = _mm_add_ps(_mm_mul_ps(derivative[0], derivative[0]),
+				_mm_add_ps(_mm_mul_ps(derivative[1], derivative[1]), _mm_mul_ps(derivative[2], derivative[2])));
+			__m128 length = _mm_sqrt_ps(squaredLength);
+			for (int axis = 0; axis < 3; axis++)
+				_mm_storeu_ps(tangents[axis] + k, _mm_div_ps(derivative[axis], length));
+		}
+	}
+#endif
+
+#if defined(SPLINE_BATCH_AVX)
+	static void EvaluateAVX(const float* coefficients, int stride, int sections,
+		const float* t, size_t k, const SplineBatchOutput& output)
+	{
+		float* const points[3] = { output.x, output.y, output.z };
+		float* const tangents[3] = { output.tangentX, output.tangentY, output.tangentZ };
+		float* const secondDerivatives[3] = { output.secondDerivativeX, output.secondDerivativeY, output.secondDerivativeZ };
+
+		__m256 s = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(t + k), _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+		s = _mm256_mul_ps(s, _mm256_set1_ps((float)sections));
+		__m256 i = _mm256_min_ps(_mm256_cvtepi32_ps(_mm256_cvttps_epi32(s)), _mm256_set1_ps((float)(sections - 1)));
+		s = _mm256_sub_ps(s, i);
+
+		int section[8];
+		_mm256_storeu_si256((__m256i*)section, _mm256_cvttps_epi32(i));
+
+		__m128 low[12], high[12];
+		LoadCoefficientsSSE(coefficients, stride, section, low);
+		LoadCoefficientsSSE(coefficients, stride, section + 4, high);
+		__m256 component[12];
+		for (int c = 0; c < 12; c++)
+			component[c] = _mm256_insertf128_ps(_mm256_castps128_ps256(low[c]), high[c], 1);
+
+		const __m256 two = _mm256_set1_ps(2.0f), three = _mm256_set1_ps(3.0f), six = _mm256_set1_ps(6.0f);
+		__m256 derivative[3];
+		for (int axis = 0; axis < 3; axis++) {
+			__m256 a = component[axis], b = component[3 + axis], c = component[6 + axis], d = component[9 + axis];
+			if (output.x) {
+				__m256 point = _mm256_add_ps(a, _mm256_mul_ps(s, _mm256_add_ps(b, _mm256_mul_ps(s, _mm256_add_ps(c, _mm256_mul_ps(s, d))))));
+				_mm256_storeu_ps(points[axis] + k, point);
+			}
+			if (output.tangentX)
+				derivative[axis] = _mm256_add_ps(b, _mm256_mul_ps(s, _mm256_add_ps(_mm256_mul_ps(two, c), _mm256_mul_ps(s, _mm256_mul_ps(three, d)))));
+			if (output.secondDerivativeX) {
+				__m256 secondDerivative = _mm256_add_ps(_mm256_mul_ps(two, c), _mm256_mul_ps(s, _mm256_mul_ps(six, d)));
+				_mm256_storeu_ps(secondDerivatives[axis] + k, secondDerivative);
+			}
+		}
+
+		if (output.tangentX) {
+			__m256 squaredLength = _mm256_add_ps(_mm256_mul_ps(derivative[0], derivative[0]),
+				_mm256_add_ps(_mm256_mul_ps(derivative[1], derivative[1]), _mm256_mul_ps(derivative[2], derivative[2])));
+			__m256 length = _mm256_sqrt_ps(squaredLength);
+			for (int axis = 0; axis < 3; axis++)
+				_mm256_storeu_ps(tangents[axis] + k, _mm256_div_ps(derivative[axis], length));
+		}
+	}
+#endif
+};
+
+#endif // !SPLINE_BATCH_H
@@ -0,0 +1,12 @@
+#include "Spline.h"
+#include "StreamingSpline.h"
+
+// Compiles the splines of the provided bases once for the whole library, instead of in every file that uses them
+template class Spline<UniformBSplineBasis>;
+template class Spline<CatmullRomBasis>;
+template class Spline<BezierBasis>;
+template class Spline<HermiteBasis>;
+template class StreamingSpline<UniformBSplineBasis>;
+template class StreamingSpline<CatmullRomBasis>;
+template class StreamingSpline<BezierBasis>;
+template class StreamingSpline<HermiteBasis>;
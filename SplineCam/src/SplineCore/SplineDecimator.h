@@ -0,0 +1,339 @@
+#ifndef SPLINE_DECIMATOR_H
+#define SPLINE_DECIMATOR_H
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <math.h>
+#include "glm/glm.hpp"
+#include "SplineBasis.h"
+
+// Removes control points of a spline while keeping its curve within a tolerance of the original one, e.g. to edit large imported paths interactively.
+// The control points are removed one at a time, always the one whose removal moves the curve the least, from a priority queue on that cost.
+// Removing a control point only changes the 4 sections whose windows include it, which become 3, so its cost is the distance between
+//	those sections before and after, plus the largest error already accumulated by them. The distance is taken between the points
+//	at the same fraction of the length of the polylines through samples of both stretches, checked at the samples of both, which bounds
+//	the Hausdorff distance between the polylines from above. Adding how far each section can stray from its chords between samples,
+//	an eighth of the squared sample spacing times its largest second derivative, bounds the distance between the curves themselves.
+//	By the triangle inequality, every section of the result then stays within its accumulated error of the original curve.
+// Each removal only changes the costs of the 3 control points on either side, which are evaluated again and moved in place in the queue,
+//	a binary heap that knows where each control point is, so it all takes O(n log n).
+// Only bases whose sections start one control point after the previous one, as B-splines and Catmull-Rom splines, can be decimated this way.
+template <typename Basis = UniformBSplineBasis>
+class SplineDecimator
+{
+	static_assert(Basis::Stride == 1 && Basis::Offset == -1, "Only splines whose sections slide one control point at a time can be decimated");
+
+public:
+
+	// Writes the control points and orientations left after removing as many as possible within the tolerance, as for Spline::Init,
+	//	and returns an upper bound of the distance between the resulting curve and the original one, at most the tolerance.
+	// The ends of a clamped spline, the first control point of a cyclic one and the control points with a custom orientation are always kept.
+	static float Decimate(const std::vector<glm::vec3>& controlPoints, const std::vector<glm::vec3>& orientations, bool isCyclic, float tolerance,
+		std::vector<glm::vec3>& outControlPoints, std::vector<glm::vec3>& outOrientations)
+	{
+		SplineDecimator decimator(controlPoints, isCyclic, tolerance);
+		unsigned int n = controlPoints.size();
+		for (unsigned int k = 0; k < n; k++)
+			decimator.isKept[k] = k == 0 || (!isCyclic && k == n - 1) || (k < orientations.size() && orientations[k] != glm::vec3());
+
+		for (unsigned int k = 0; k < n; k++)
+			decimator.Update(k);
+		while (!decimator.queue.empty() && decimator.remaining > (isCyclic ? 4u : 2u)) {
+			unsigned int k = decimator.queue[0];
+			decimator.Dequeue(k);
+			decimator.Remove(k);
+		}
+
+		outControlPoints.clear();
+		outOrientations.clear();
+		float error = 0.0f;
+		if (n == 0)
+			return error;
+		// Walk the control points left from the first one, up to the last one of a clamped spline, which is its own next, or back to the first of a cyclic one
+		unsigned int k = 0;
+		for (;;) {
+			outControlPoints.push_back(controlPoints[k]);
+			outOrientations.push_back(k < orientations.size() ? orientations[k] : glm::vec3());
+			if (!decimator.HasSection(k) || decimator.next[k] == 0)
+				break;
+			error = std::max(error, decimator.sectionErrors[k]);
+			k = decimator.next[k];
+		}
+		return error;
+	}
+
+private:
+
+	// The number of samples along each section at which the curves before and after a removal are compared.
+	// The bound on the distance between a section and its chords shrinks with its square, and with fewer, it takes most of the tolerance.
+	static constexpr int SampleCount = 8;
+
+	// The position in the queue of the control points that are not in it
+	static constexpr unsigned int NotQueued = UINT_MAX;
+
+	SplineDecimator(const std::vector<glm::vec3>& points_, bool isCyclic_, float tolerance_)
+		: points(points_)
+		, isCyclic(isCyclic_)
+		, tolerance(tolerance_)
+	{
+		unsigned int n = points.size();
+		remaining = n;
+		previous.resize(n);
+		next.resize(n);
+		for (unsigned int k = 0; k < n; k++) {
+			// The ends of a clamped spline are their own neighbors, as the windows of the end sections repeat them
+			previous[k] = k > 0 ? k - 1 : isCyclic ? n - 1 : 0;
+			next[k] = k + 1 < n ? k + 1 : isCyclic ? 0 : k;
+		}
+		isKept.assign(n, 0);
+		queuePositions.assign(n, NotQueued);
+		costs.resize(n);
+		sectionErrors.assign(n, 0.0f);
+
+		// The weights of the control points of a window at each sample of its section
+		for (int j = 0; j <= SampleCount; j++) {
+			float t = (float)j / SampleCount;
+			for (int c = 0; c < 4; c++)
+				weights[j][c] = Basis::Matrix[0][c] + t * (Basis::Matrix[1][c] + t * (Basis::Matrix[2][c] + t * Basis::Matrix[3][c]));
+		}
+		// And of the second derivative at both ends of the section, between which it is linear, so its length is largest at one of them
+		for (int c = 0; c < 4; c++) {
+			secondDerivativeWeights[0][c] = 2.0f * Basis::Matrix[2][c];
+			secondDerivativeWeights[1][c] = 2.0f * Basis::Matrix[2][c] + 6.0f * Basis::Matrix[3][c];
+		}
+	}
+
+	// Whether there is a section from the control point to the next one, which is keyed by it
+	bool HasSection(unsigned int k) const { return next[k] != k; }
+
+	// Evaluates the cost of removing the control point again and moves it in the queue, or out of it if it has to be kept or would move the curve too far
+	void Update(unsigned int k)
+	{
+		if (isKept[k])
+			return;
+		float cost = GetRemovalCost(k);
+		unsigned int position = queuePositions[k];
+		if (cost > tolerance) {
+			if (position != NotQueued)
+				Dequeue(k);
+			return;
+		}
+
+		float previousCost = costs[k];
+		costs[k] = cost;
+		if (position == NotQueued) {
+			position = queue.size();
+			queue.push_back(k);
+			queuePositions[k] = position;
+			SiftUp(position);
+		}
+		else if (cost < previousCost)
+			SiftUp(position);
+		else
+			SiftDown(position);
+	}
+
+	void Dequeue(unsigned int k)
+	{
+		unsigned int position = queuePositions[k], last = queue.back();
+		queuePositions[k] = NotQueued;
+		queue.pop_back();
+		if (last == k)
+			return;
+		queue[position] = last;
+		queuePositions[last] = position;
+		if (position > 0 && costs[last] < costs[queue[(position - 1) / 2]])
+			SiftUp(position);
+		else
+			SiftDown(position);
+	}
+
+	void SiftUp(unsigned int position)
+	{
+		unsigned int k = queue[position];
+		while (position > 0) {
+			unsigned int parent = (position - 1) / 2;
+			if (costs[queue[parent]] <= costs[k])
+				break;
+			queue[position] = queue[parent];
+			queuePositions[queue[position]] = position;
+			position = parent;
+		}
+		queue[position] = k;
+		queuePositions[k] = position;
+	}
+
+	void SiftDown(unsigned int position)
+	{
+		unsigned int k = queue[position], size = queue.size();
+		for (;;) {
+			unsigned int child = 2 * position + 1;
+			if (child >= size)
+				break;
+			if (child + 1 < size && costs[queue[child + 1]] < costs[queue[child]])
+				child++;
+			if (costs[k] <= costs[queue[child]])
+				break;
+			queue[position] = queue[child];
+			queuePositions[queue[position]] = position;
+			position = child;
+		}
+		queue[position] = k;
+		queuePositions[k] = position;
+	}
+
+	void Remove(unsigned int k)
+	{
+		unsigned int p = previous[k], n = next[k];
+		next[p] = n;
+		previous[n] = p;
+		remaining--;
+
+		// The 3 sections that replace the 4 around it inherit the error of the removal
+		unsigned int keys[3];
+		int keyCount = GetSectionKeys(previous[p], p, n, n, keys);
+		for (int i = 0; i < keyCount; i++)
+			sectionErrors[keys[i]] = costs[k];
+
+		// The costs of the control points up to 3 links away depend on these sections
+		unsigned int before = p, after = n;
+		for (int i = 0; i < 3; i++) {
+			Update(before);
+			Update(after);
+			before = previous[before];
+			after = next[after];
+		}
+	}
+
+	// The distinct control points among the given ones in order that key a section
+	int GetSectionKeys(unsigned int a, unsigned int b, unsigned int c, unsigned int d, unsigned int* outKeys) const
+	{
+		const unsigned int candidates[4] = { a, b, c, d };
+		int count = 0;
+		for (unsigned int candidate : candidates)
+			if (HasSection(candidate) && std::find(outKeys, outKeys + count, candidate) == outKeys + count)
+				outKeys[count++] = candidate;
+		return count;
+	}
+
+	// The distance between the sections around the control point with and without it, plus the largest error they already carry,
+	//	or infinity if that is over the tolerance
+	float GetRemovalCost(unsigned int k)
+	{
+		unsigned int p = previous[k], n = next[k];
+		if (p == k || n == k || p == n)
+			return INFINITY;
+
+		unsigned int keys[4];
+		int keyCount = GetSectionKeys(previous[p], p, k, n, keys);
+		float carried = 0.0f;
+		for (int i = 0; i < keyCount; i++)
+			carried = std::max(carried, sectionErrors[keys[i]]);
+		float budget = tolerance - carried;
+		if (budget < 0.0f)
+			return INFINITY;
+
+		Polyline before, after;
+		SampleSections(keys, keyCount, before);
+		next[p] = n;
+		previous[n] = p;
+		keyCount = GetSectionKeys(previous[p], p, n, n, keys);
+		SampleSections(keys, keyCount, after);
+		next[p] = k;
+		previous[n] = k;
+
+		// What is left of the budget once the curves stray as far as they can from their polylines
+		float chordErrors = before.chordError + after.chordError;
+		budget -= chordErrors;
+		if (budget < 0.0f)
+			return INFINITY;
+
+		float distance = GetDistance(before, after, budget);
+		if (distance <= budget)
+			distance = std::max(distance, GetDistance(after, before, budget));
+		return distance <= budget ? carried + chordErrors + distance : INFINITY;
+	}
+
+	// The samples along at most the 4 sections around a control point, the length of the polyline through them up to each one,
+	//	and the largest distance from a section to the polyline
+	struct Polyline
+	{
+		glm::vec3 points[4 * SampleCount + 1];
+		float lengths[4 * SampleCount + 1];
+		int count;
+		float chordError;
+	};
+
+	// Samples the consecutive sections keyed by the given control points, from the start of the first one to the end of the last one
+	void SampleSections(const unsigned int* keys, int keyCount, Polyline& outPolyline) const
+	{
+		int count = 0;
+		float squaredSecondDerivative = 0.0f;
+		for (int i = 0; i < keyCount; i++) {
+			unsigned int a = keys[i], b = next[a];
+			const glm::vec3& p0 = points[previous[a]];
+			const glm::vec3& p1 = points[a];
+			const glm::vec3& p2 = points[b];
+			const glm::vec3& p3 = points[next[b]];
+			for (int j = 0; j < 2; j++) {
+				const float* w = secondDerivativeWeights[j];
+				glm::vec3 secondDerivative = w[0] * p0 + w[1] * p1 + w[2] * p2 + w[3] * p3;
+				squaredSecondDerivative = std::max(squaredSecondDerivative, glm::dot(secondDerivative, secondDerivative));
+			}
+			for (int j = i > 0 ? 1 : 0; j <= SampleCount; j++) {
+				glm::vec3 sample = weights[j][0] * p0 + weights[j][1] * p1 + weights[j][2] * p2 + weights[j][3] * p3;
+				outPolyline.lengths[count] = count > 0 ? outPolyline.lengths[count - 1] + glm::length(sample - outPolyline.points[count - 1]) : 0.0f;
+				outPolyline.points[count++] = sample;
+			}
+		}
+		outPolyline.count = count;
+		outPolyline.chordError = sqrtf(squaredSecondDerivative) / (8.0f * SampleCount * SampleCount);
+	}
+
+	// The largest distance from the samples of a polyline to the points at the same fraction of the length along another, or just past the budget once it is over it
+	static float GetDistance(const Polyline& samples, const Polyline& polyline, float budget)
+	{
+		float squaredBudget = budget * budget, squaredDistance = 0.0f;
+		float scale = samples.lengths[samples.count - 1] > 0.0f ? polyline.lengths[polyline.count - 1] / samples.lengths[samples.count - 1] : 0.0f;
+		int segment = 0, segments = polyline.count - 1;
+		for (int k = 0; k < samples.count; k++) {
+			float length = samples.lengths[k] * scale;
+			while (segment + 1 < segments && polyline.lengths[segment + 1] < length)
+				segment++;
+			float segmentLength = polyline.lengths[segment + 1] - polyline.lengths[segment];
+			float f = segmentLength > 0.0f ? glm::clamp((length - polyline.lengths[segment]) / segmentLength, 0.0f, 1.0f) : 0.0f;
+			glm::vec3 d = samples.points[k] - glm::mix(polyline.points[segment], polyline.points[segment + 1], f);
+			squaredDistance = std::max(squaredDistance, glm::dot(d, d));
+			if (squaredDistance > squaredBudget)
+				break;
+		}
+		return sqrtf(squaredDistance);
+	}
+
+	const std::vector<glm::vec3>& points;
+	bool isCyclic;
+	float tolerance;
+
+	// The control points left, as a doubly linked list over their original indices
+	std::vector<unsigned int> previous;
+	std::vector<unsigned int> next;
+	unsigned int remaining;
+
+	std::vector<char> isKept;
+
+	// The control points that can be removed within the tolerance, as a binary heap on the cost of their removal, the cheapest first,
+	//	and the position of each control point in it
+	std::vector<unsigned int> queue;
+	std::vector<unsigned int> queuePositions;
+	std::vector<float> costs;
+
+	// The largest distance from the original curve accumulated by the section keyed by each control point
+	std::vector<float> sectionErrors;
+
+	// The weights of the control points of a window at each sample of its section, and of the second derivative at its ends
+	float weights[SampleCount + 1][4];
+	float secondDerivativeWeights[2][4];
+};
+
+#endif // !SPLINE_DECIMATOR_H
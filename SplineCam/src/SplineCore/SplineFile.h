@@ -0,0 +1,269 @@
+#ifndef SPLINE_FILE_H
+#define SPLINE_FILE_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <math.h>
+#include "glm/glm.hpp"
+#include "MappedFile.h"
+
+// The binary spline file format. A file is a header followed by its arrays, each 16-byte aligned, so they can be used in place once mapped:
+//	- the control points and their custom orientations, as packed triples of floats
+//	- optionally, the baked points of the spline: the offset of the first point of each section, with the end of the last one,
+//	  and the position, the parameter t [0, 1] of its section and the arc length from the start of its section of each point,
+//	  along with the arc length at the start of each section, with the total length at the end.
+// Everything is little-endian, as on all the platforms the app runs on.
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be packed to be mapped from a file");
+
+static constexpr char SplineFileMagic[8] = { 'S', 'P', 'L', 'I', 'N', 'E', 0, 0 };
+
+// Bumped whenever the layout changes. Files of other versions are rejected.
+static constexpr uint32_t SplineFileVersion = 1;
+
+// The largest sample budget accepted from a file, far more points than any spline is drawn with
+static constexpr uint32_t SplineFileMaximumSampleBudget = 1u << 26;
+
+enum SplineFileFlags : uint32_t
+{
+	SplineFileCyclic = 1,
+	SplineFileTessellation = 2
+};
+
+// The header at the start of a spline file. The offsets of the arrays are in bytes from the start of the file.
+struct SplineFileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t basis; // the Id of the basis of the spline
+	uint32_t flags;
+	uint32_t sampleBudget;
+	float adaptiveSamplingDetailAngleThreshold;
+	float adaptiveSamplingDetailDistanceThreshold;
+	float arcLengthTolerance;
+	uint32_t reserved;
+	uint64_t fileSize;
+
+	uint64_t controlPointCount;
+	uint64_t controlPoints;
+	uint64_t orientations;
+
+	// Only set with SplineFileTessellation
+	uint64_t sectionCount;
+	uint64_t sampleCount;
+	uint64_t sectionOffsets;
+	uint64_t splinePoints;
+	uint64_t splineParameters;
+	uint64_t splineDistances;
+	uint64_t sectionStartDistances;
+};
+
+// Writes a spline file: the header, which is written again at the end once the offsets are known, then the arrays one after the other
+class SplineFileWriter
+{
+public:
+	SplineFileWriter() {}
+	~SplineFileWriter() { if (file) fclose(file); }
+
+	SplineFileWriter(const SplineFileWriter&) = delete;
+	SplineFileWriter& operator=(const SplineFileWriter&) = delete;
+
+	bool Open(const char* path)
+	{
+		file = fopen(path, "wb");
+		if (!file)
+			return false;
+		SplineFileHeader header = {};
+		size = 0;
+		return Write(&header, sizeof(header));
+	}
+
+	// Appends the array, aligned to 16 bytes, and returns its offset
+	uint64_t Append(const void* data, size_t bytes)
+	{
+		static const char padding[16] = {};
+		if (size % 16 != 0)
+			Write(padding, 16 - size % 16);
+		uint64_t offset = size;
+		Write(data, bytes);
+		return offset;
+	}
+
+	uint64_t Size() const { return size; }
+
+	// Writes the header over the placeholder at the start, and closes the file
+	bool Close(const SplineFileHeader& header)
+	{
+		bool isWritten = isGood && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+		isWritten = fclose(file) == 0 && isWritten;
+		file = nullptr;
+		return isWritten;
+	}
+
+private:
+
+	bool Write(const void* data, size_t bytes)
+	{
+		if (bytes > 0 && fwrite(data, bytes, 1, file) != 1)
+			isGood = false;
+		size += bytes;
+		return isGood;
+	}
+
+	FILE* file = nullptr;
+	uint64_t size = 0;
+	bool isGood = true;
+};
+
+// A read-only view of a spline file, mapped into memory.
+// The arrays are used in place, without parsing nor copying them, so opening even a huge file is immediate,
+//	and all the processes that map the same file share a single copy of it in memory.
+// The baked points can be walked by arc length straight from the view, without building a Spline.
+class SplineFileView
+{
+public:
+	SplineFileView() {}
+
+	SplineFileView(const SplineFileView&) = delete;
+	SplineFileView& operator=(const SplineFileView&) = delete;
+
+	// Maps the file and checks its header and that all its arrays lie inside it. Returns false, with the view closed, if it is not a valid spline file.
+	bool Open(const char* path)
+	{
+		if (!file.Open(path) || file.Size() < sizeof(SplineFileHeader) || !IsValid()) {
+			Close();
+			return false;
+		}
+		data = file.Data();
+		return true;
+	}
+
+	void Close()
+	{
+		file.Close();
+		data = nullptr;
+	}
+
+	bool IsOpen() const { return data != nullptr; }
+	const SplineFileHeader& Header() const { return *(const SplineFileHeader*)data; }
+
+	bool IsCyclic() const { return (Header().flags & SplineFileCyclic) != 0; }
+	bool HasTessellation() const { return (Header().flags & SplineFileTessellation) != 0; }
+
+	size_t ControlPointCount() const { return (size_t)Header().controlPointCount; }
+	const glm::vec3* ControlPoints() const { return Array<glm::vec3>(Header().controlPoints); }
+	const glm::vec3* Orientations() const { return Array<glm::vec3>(Header().orientations); }
+
+	size_t SectionCount() const { return (size_t)Header().sectionCount; }
+	size_t SampleCount() const { return (size_t)Header().sampleCount; }
+	const unsigned int* SectionOffsets() const { return Array<unsigned int>(Header().sectionOffsets); }
+	const glm::vec3* SplinePoints() const { return Array<glm::vec3>(Header().splinePoints); }
+	const float* SplineParameters() const { return Array<float>(Header().splineParameters); }
+	const float* SplineDistances() const { return Array<float>(Header().splineDistances); }
+	const float* SectionStartDistances() const { return Array<float>(Header().sectionStartDistances); }
+
+	// The length of the baked spline, or 0 without a baked tessellation
+	float GetLength() const { return HasTessellation() ? SectionStartDistances()[SectionCount()] : 0.0f; }
+
+	// Returns the baked point at the given distance [0, length] along the spline, interpolated between the two enclosing it.
+	// This and GetParameterAtDistance need the baked tessellation.
+	glm::vec3 GetPointAtDistance(float distance) const
+	{
+		unsigned int j;
+		float f;
+		FindSample(distance, j, f);
+		const glm::vec3* points = SplinePoints();
+		return points[j - 1] + (points[j] - points[j - 1]) * f;
+	}
+
+	// Returns the value of the parameter t [0, 1] at the given distance [0, length] along the spline, interpolated between the baked points
+	float GetParameterAtDistance(float distance) const
+	{
+		unsigned int j;
+		float f;
+		int i = FindSample(distance, j, f);
+		const float* parameters = SplineParameters();
+		return (i + parameters[j - 1] + (parameters[j] - parameters[j - 1]) * f) / SectionCount();
+	}
+
+private:
+
+	template <typename T>
+	const T* Array(uint64_t offset) const { return (const T*)(data + offset); }
+
+	// Whether the header is of this version with settings a spline can be computed with, and all the arrays fit in the file,
+	//	so no access through the view can go out of it
+	bool IsValid() const
+	{
+		const SplineFileHeader& header = *(const SplineFileHeader*)file.Data();
+		size_t size = file.Size();
+		if (memcmp(header.magic, SplineFileMagic, sizeof(SplineFileMagic)) != 0 || header.version != SplineFileVersion || header.fileSize != size)
+			return false;
+
+		// Written this way, so NaN fails them too
+		if (!(header.arcLengthTolerance > 0.0f && header.arcLengthTolerance < INFINITY)
+				|| !(header.adaptiveSamplingDetailAngleThreshold > 0.0f && header.adaptiveSamplingDetailAngleThreshold < INFINITY)
+				|| !(header.adaptiveSamplingDetailDistanceThreshold > 0.0f && header.adaptiveSamplingDetailDistanceThreshold < INFINITY)
+				|| header.sampleBudget > SplineFileMaximumSampleBudget)
+			return false;
+
+		uint64_t vec3Bytes = sizeof(glm::vec3);
+		if (header.controlPointCount > size / vec3Bytes || !Fits(header.controlPoints, header.controlPointCount * vec3Bytes)
+				|| !Fits(header.orientations, header.controlPointCount * vec3Bytes))
+			return false;
+		if (!(header.flags & SplineFileTessellation))
+			return true;
+
+		if (header.sectionCount == 0 || header.sectionCount >= size / sizeof(float) || header.sampleCount > size / vec3Bytes
+				|| !Fits(header.sectionOffsets, (header.sectionCount + 1) * sizeof(unsigned int))
+				|| !Fits(header.splinePoints, header.sampleCount * vec3Bytes)
+				|| !Fits(header.splineParameters, header.sampleCount * sizeof(float))
+				|| !Fits(header.splineDistances, header.sampleCount * sizeof(float))
+				|| !Fits(header.sectionStartDistances, (header.sectionCount + 1) * sizeof(float)))
+			return false;
+
+		// Every section has at least its two end points, in order. Compared in 64 bits, so an offset near the top of the range can't wrap past the check
+		const unsigned int* offsets = (const unsigned int*)(file.Data() + header.sectionOffsets);
+		if (offsets[0] != 0 || offsets[header.sectionCount] != header.sampleCount)
+			return false;
+		for (uint64_t i = 0; i < header.sectionCount; i++)
+			if ((uint64_t)offsets[i + 1] < (uint64_t)offsets[i] + 2)
+				return false;
+		return true;
+	}
+
+	bool Fits(uint64_t offset, uint64_t bytes) const
+	{
+		size_t size = file.Size();
+		return offset % 16 == 0 && offset >= sizeof(SplineFileHeader) && offset <= size && bytes <= size - offset;
+	}
+
+	// Finds the section i and the index j, local to it, of the first baked point past the distance, and the fraction f of the way to it from the previous one
+	int FindSample(float distance, unsigned int& j, float& f) const
+	{
+		int sections = (int)SectionCount();
+		const float* sectionStartDistances = SectionStartDistances();
+		distance = distance < 0 ? 0 : distance > GetLength() ? GetLength() : distance;
+		int i = (int)(std::upper_bound(sectionStartDistances, sectionStartDistances + sections + 1, distance) - sectionStartDistances) - 1;
+		i = i < 0 ? 0 : i < sections ? i : sections - 1;
+
+		unsigned int first = SectionOffsets()[i], samples = SectionOffsets()[i + 1] - first;
+		const float* distances = SplineDistances() + first;
+		float localDistance = distance - sectionStartDistances[i];
+		unsigned int k = (unsigned int)(std::upper_bound(distances, distances + samples, localDistance) - distances);
+		k = k < 1 ? 1 : k < samples ? k : samples - 1;
+
+		float segment = distances[k] - distances[k - 1];
+		f = segment > 0.0f ? (localDistance - distances[k - 1]) / segment : 0.0f;
+		j = first + k;
+		return i;
+	}
+
+	MappedFile file;
+
+	// The start of the mapped file, only set once it is known to be valid
+	const char* data = nullptr;
+};
+
+#endif // !SPLINE_FILE_H
@@ -0,0 +1,193 @@
+#ifndef SPLINE_FITTER_H
+#define SPLINE_FITTER_H
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <math.h>
+#include "glm/glm.hpp"
+#include "SplineBasis.h"
+
+// Fits the control points of a clamped uniform cubic B-spline, as drawn by Spline<>, to timestamped samples, e.g. a recorded camera trajectory.
+// The timestamps are mapped linearly to the parameter t [0, 1] of the spline, so Spline::GetPoint(t) follows the samples in time.
+// Each sample only weighs on the 4 control points of its section, so the normal equations of the least-squares problem form a symmetric band
+//	of 3 diagonals on each side. They are accumulated straight into that band and solved by a banded Cholesky factorization,
+//	in O(samples + control points) time and O(control points) memory.
+// A tiny penalty on the second differences of the control points keeps the system well-posed where sections have too few samples.
+// As the ends of Spline<> are clamped by repeating their control points, the curvature of the first and last sections is tied to their speed,
+//	so the fit is looser there than along the rest of the spline.
+class SplineFitter
+{
+public:
+
+	// Fits controlPointCount control points to the count samples, with the given timestamps in increasing order, or evenly spaced if null.
+	// Returns false, leaving outControlPoints empty, if there are fewer than 2 samples or control points or the timestamps span no time.
+	// The largest distance from a sample to the fitted spline at its time is written to outMaxError, if not null.
+	static bool Fit(const double* times, const glm::vec3* positions, size_t count, unsigned int controlPointCount,
+		std::vector<glm::vec3>& outControlPoints, float* outMaxError = nullptr)
+	{
+		outControlPoints.clear();
+		if (count < 2 || controlPointCount < 2 || (times && !(times[count - 1] > times[0])))
+			return false;
+
+		const int n = controlPointCount, sections = UniformBSplineBasis::SectionCount(n, false);
+		std::vector<double> band((size_t)n * BandSize, 0.0);
+		std::vector<glm::dvec3> rightHandSide(n, glm::dvec3(0.0));
+
+		// Accumulate the normal equations, A^T A into the band and A^T b into the right-hand side
+		for (size_t k = 0; k < count; k++) {
+			int indices[4];
+			double weights[4];
+			int weightCount = GetWeights(GetParameter(times, count, k), sections, n, indices, weights);
+			glm::dvec3 position(positions[k]);
+			for (int a = 0; a < weightCount; a++) {
+				rightHandSide[indices[a]] += weights[a] * position;
+				for (int b = 0; b <= a; b++)
+					band[(size_t)indices[a] * BandSize + indices[a] - indices[b]] += weights[a] * weights[b];
+			}
+		}
+
+		// Add the penalty on the second differences, P[j - 1] - 2 P[j] + P[j + 1], relative to the samples per control point
+		const double smoothing = 1e-6 * count / n;
+		for (int j = 1; j + 1 < n; j++) {
+			const double coefficients[3] = { 1.0, -2.0, 1.0 };
+			for (int a = 0; a < 3; a++)
+				for (int b = 0; b <= a; b++)
+					band[(size_t)(j - 1 + a) * BandSize + a - b] += smoothing * coefficients[a] * coefficients[b];
+		}
+
+		if (!SolveBanded(band, rightHandSide))
+			return false;
+
+		outControlPoints.resize(n);
+		for (int j = 0; j < n; j++)
+			outControlPoints[j] = glm::vec3(rightHandSide[j]);
+		if (outMaxError)
+			*outMaxError = GetMaxError(times, positions, count, outControlPoints);
+		return true;
+	}
+
+	// Fits the fewest control points, up to maximumControlPointCount or as many as samples if 0, for which no sample is farther than the tolerance
+	//	from the spline. After each fit the count is raised by how much the error has to shrink, at the rate it shrank with the count so far,
+	//	so a few fits are enough. Returns false, as Fit, or if even the largest count does not reach the tolerance, with its fit in outControlPoints.
+	static bool FitWithinTolerance(const double* times, const glm::vec3* positions, size_t count, float tolerance,
+		std::vector<glm::vec3>& outControlPoints, float* outMaxError = nullptr, unsigned int maximumControlPointCount = 0)
+	{
+		unsigned int maximum = maximumControlPointCount ? maximumControlPointCount : (unsigned int)std::min<size_t>(count, UINT_MAX);
+		unsigned int controlPoints = std::min(4u, maximum), previousControlPoints = 0;
+		float previousError = 0.0f;
+		for (;;) {
+			float error;
+			if (!Fit(times, positions, count, controlPoints, outControlPoints, &error))
+				return false;
+			if (outMaxError)
+				*outMaxError = error;
+			if (error <= tolerance)
+				return true;
+			if (controlPoints == maximum)
+				return false;
+
+			// The error of a smooth curve goes down with the fourth power of the number of sections, and slower where the clamped ends
+			//	or noise dominate it, so the rate is measured between the last two fits
+			double order = 4.0;
+			if (previousControlPoints > 0 && previousError > error)
+				order = glm::clamp(log((double)previousError / error) / log((double)controlPoints / previousControlPoints), 1.0, 4.0);
+			double growth = std::max(1.25, 1.1 * pow(error / std::max(tolerance, 1e-30f), 1.0 / order));
+			previousControlPoints = controlPoints;
+			previousError = error;
+			controlPoints = (unsigned int)std::min<double>(maximum, ceil(controlPoints * growth));
+		}
+	}
+
+	// The largest distance from a sample to the spline with the given control points at its time
+	static float GetMaxError(const double* times, const glm::vec3* positions, size_t count, const std::vector<glm::vec3>& controlPoints)
+	{
+		const int n = controlPoints.size(), sections = UniformBSplineBasis::SectionCount(n, false);
+		float squaredError = 0.0f;
+		for (size_t k = 0; k < count; k++) {
+			int indices[4];
+			double weights[4];
+			int weightCount = GetWeights(GetParameter(times, count, k), sections, n, indices, weights);
+			glm::vec3 point(0.0f);
+			for (int a = 0; a < weightCount; a++)
+				point += (float)weights[a] * controlPoints[indices[a]];
+			glm::vec3 d = point - positions[k];
+			squaredError = std::max(squaredError, glm::dot(d, d));
+		}
+		return sqrtf(squaredError);
+	}
+
+private:
+
+	// The number of stored diagonals of the band: the main one and the 3 below it, the element of row j and column j - d at j * BandSize + d
+	static constexpr int BandSize = 4;
+
+	// The parameter t [0, 1] of the k-th sample
+	static double GetParameter(const double* times, size_t count, size_t k)
+	{
+		return times ? (times[k] - times[0]) / (times[count - 1] - times[0]) : (double)k / (count - 1);
+	}
+
+	// Writes the distinct control points the spline is made of at the parameter t [0, 1] and their weights, in order, and returns how many there are.
+	// The clamped ends repeat their control point in the window of their section, as in Spline::GetIndex, so their weights are merged.
+	static int GetWeights(double t, int sections, int n, int outIndices[4], double outWeights[4])
+	{
+		t *= sections;
+		int i = (int)t;
+		i = i < 0 ? 0 : i < sections ? i : sections - 1;
+		t -= i;
+
+		const float (&m)[4][4] = UniformBSplineBasis::Matrix;
+		int weightCount = 0;
+		for (int c = 0; c < 4; c++) {
+			double weight = m[0][c] + t * (m[1][c] + t * (m[2][c] + t * m[3][c]));
+			int index = UniformBSplineBasis::Stride * i + UniformBSplineBasis::Offset + c;
+			index = index < 0 ? 0 : index < n ? index : n - 1;
+			if (weightCount > 0 && outIndices[weightCount - 1] == index)
+				outWeights[weightCount - 1] += weight;
+			else {
+				outIndices[weightCount] = index;
+				outWeights[weightCount++] = weight;
+			}
+		}
+		return weightCount;
+	}
+
+	// Solves the symmetric positive definite banded system in place, overwriting the band with its Cholesky factor L, and the right-hand side with the solution.
+	// Returns false if the system is not positive definite.
+	static bool SolveBanded(std::vector<double>& band, std::vector<glm::dvec3>& rightHandSide)
+	{
+		const int n = rightHandSide.size();
+		for (int j = 0; j < n; j++) {
+			double* row = &band[(size_t)j * BandSize];
+			for (int k = std::max(0, j - (BandSize - 1)); k <= j; k++) {
+				const double* other = &band[(size_t)k * BandSize];
+				double sum = row[j - k];
+				for (int m = std::max(0, j - (BandSize - 1)); m < k; m++)
+					sum -= row[j - m] * other[k - m];
+				if (k < j)
+					row[j - k] = sum / other[0];
+				else if (sum > 0.0)
+					row[0] = sqrt(sum);
+				else
+					return false;
+			}
+		}
+
+		// Forward substitution with L, then back substitution with its transpose
+		for (int j = 0; j < n; j++) {
+			const double* row = &band[(size_t)j * BandSize];
+			for (int k = std::max(0, j - (BandSize - 1)); k < j; k++)
+				rightHandSide[j] -= row[j - k] * rightHandSide[k];
+			rightHandSide[j] /= row[0];
+		}
+		for (int j = n - 1; j >= 0; j--) {
+			for (int k = j + 1; k < std::min(n, j + BandSize); k++)
+				rightHandSide[j] -= band[(size_t)k * BandSize + k - j] * rightHandSide[k];
+			rightHandSide[j] /= band[(size_t)j * BandSize];
+		}
+		return true;
+	}
+};
+
+#endif // !SPLINE_FITTER_H
@@ -0,0 +1,341 @@
+#ifndef SPLINE_IMPORTER_H
+#define SPLINE_IMPORTER_H
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "glm/glm.hpp"
+#include "MappedFile.h"
+
+// std::from_chars for floats is only in recent standard libraries (Visual Studio 2019 16.4, GCC 11), with a fallback on strtof
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+#if defined(__cpp_lib_to_chars) || (defined(_MSC_VER) && _MSC_VER >= 1924)
+#define SPLINE_IMPORTER_FROM_CHARS
+#endif
+
+// Imports the control points of a spline from a text file, e.g. a GPS or IMU export, for Spline::Init.
+// Two formats are read, told apart by their first character:
+//	- CSV: one control point per line, as x, y, z or x, y, z, ox, oy, oz with its custom orientation, separated by commas, semicolons or whitespace.
+//	  Blank lines, lines starting with # and lines not starting with a number, such as a header, are skipped.
+//	- JSON: { "points": [ [x, y, z], [x, y, z, ox, oy, oz], ... ] }, or just the array. Any other member is ignored.
+// The file is mapped and, for JSON, the array of points found first, skipping the other members.
+//	Then it is split into one chunk per thread at record boundaries. The records of each chunk are counted first,
+//	so the control points and orientations are allocated once, and then parsed by all the threads straight into their place.
+class SplineImporter
+{
+public:
+
+	// Returns false, leaving the vectors empty, if the file cannot be read, has no control points or a malformed record.
+	// The orientations are zero for the control points without one, as in Spline::Init.
+	static bool Import(const char* path, std::vector<glm::vec3>& outControlPoints, std::vector<glm::vec3>& outOrientations, unsigned int threadCount = 0)
+	{
+		outControlPoints.clear();
+		outOrientations.clear();
+
+		MappedFile file;
+		if (!file.Open(path))
+			return false;
+		const char* begin = file.Data();
+		const char* end = begin + file.Size();
+
+		const char* first = begin;
+		while (first < end && IsSpace(*first))
+			first++;
+		bool isJson = first < end && (*first == '{' || *first == '[');
+		if (isJson && !FindJsonPoints(first, end, begin, end))
+			return false;
+		size_t size = end - begin;
+
+		// Not worth a thread for less than this
+		const size_t minimumChunkSize = 1 << 20;
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		size_t chunks = std::max<size_t>(1, std::min<size_t>(threadCount, size / minimumChunkSize));
+
+		// Each chunk ends where the next one starts, just past the end of a record, so no record is split nor lost
+		std::vector<const char*> bounds(chunks + 1);
+		bounds[0] = begin;
+		bounds[chunks] = end;
+		for (size_t k = 1; k < chunks; k++) {
+			const char* bound = std::max(bounds[k - 1], begin + size / chunks * k);
+			const char* next = (const char*)memchr(bound, isJson ? ']' : '\n', end - bound);
+			bounds[k] = next ? next + 1 : end;
+		}
+
+		// Count the records of each chunk, to place them
+		std::vector<size_t> offsets(chunks + 1, 0);
+		RunChunks(chunks, [&](size_t k) {
+			offsets[k + 1] = isJson ? CountJson(bounds[k], bounds[k + 1]) : CountCsv(bounds[k], bounds[k + 1]);
+		});
+		for (size_t k = 0; k < chunks; k++)
+			offsets[k + 1] += offsets[k];
+		if (offsets[chunks] == 0)
+			return false;
+
+		outControlPoints.resize(offsets[chunks]);
+		outOrientations.resize(offsets[chunks]);
+		std::vector<char> isParsed(chunks);
+		RunChunks(chunks, [&](size_t k) {
+			glm::vec3* points = outControlPoints.data() + offsets[k];
+			glm::vec3* orientations = outOrientations.data() + offsets[k];
+			size_t count = offsets[k + 1] - offsets[k];
+			isParsed[k] = isJson ? ParseJson(bounds[k], bounds[k + 1], points, orientations, count) : ParseCsv(bounds[k], bounds[k + 1], points, orientations, count);
+		});
+
+		if (std::find(isParsed.begin(), isParsed.end(), 0) != isParsed.end()) {
+			outControlPoints.clear();
+			outOrientations.clear();
+			return false;
+		}
+		return true;
+	}
+
+private:
+
+	// Runs body(k) for each chunk k, all but the first on their own thread
+	template <typename Body>
+	static void RunChunks(size_t chunks, Body body)
+	{
+		std::vector<std::thread> workers;
+		for (size_t k = 1; k < chunks; k++)
+			workers.emplace_back(body, k);
+		body(0);
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+	static bool IsNumberStart(char c) { return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.'; }
+
+	// The first character of the line at or after p that is not a space or a tab, or the end of the line
+	static const char* SkipBlanks(const char* p, const char* end)
+	{
+		while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+			p++;
+		return p;
+	}
+
+	static const char* EndOfLine(const char* p, const char* end)
+	{
+		const char* next = (const char*)memchr(p, '\n', end - p);
+		return next ? next : end;
+	}
+
+	// A CSV record is a line that starts with a number
+	static size_t CountCsv(const char* p, const char* end)
+	{
+		size_t count = 0;
+		while (p < end) {
+			p = SkipBlanks(p, end);
+			if (p < end && IsNumberStart(*p))
+				count++;
+			p = EndOfLine(p, end) + 1;
+		}
+		return count;
+	}
+
+	static bool ParseCsv(const char* p, const char* end, glm::vec3* points, glm::vec3* orientations, size_t count)
+	{
+		size_t parsed = 0;
+		while (p < end) {
+			p = SkipBlanks(p, end);
+			const char* lineEnd = EndOfLine(p, end);
+			if (p < lineEnd && IsNumberStart(*p)) {
+				if (parsed == count || !ParseRecord(p, lineEnd, ",;", points[parsed], orientations[parsed]))
+					return false;
+				parsed++;
+			}
+			p = lineEnd + 1;
+		}
+		return parsed == count;
+	}
+
+	// Finds the elements of the array of points of the JSON document starting at first: the document itself if it is an array,
+	//	or else the "points" member of the top-level object. Returns false if there is none, or it is not an array of arrays.
+	static bool FindJsonPoints(const char* first, const char* end, const char*& outBegin, const char*& outEnd)
+	{
+		const char* p = first;
+		if (*p == '{') {
+			p++;
+			while (true) {
+				p = SkipSpaces(p, end);
+				if (p == end || *p != '"')
+					return false;
+				const char* key = p + 1;
+				p = SkipJsonString(p, end);
+				if (!p)
+					return false;
+				bool isPoints = p - 1 - key == 6 && memcmp(key, "points", 6) == 0;
+				p = SkipSpaces(p, end);
+				if (p == end || *p != ':')
+					return false;
+				p = SkipSpaces(p + 1, end);
+				if (isPoints)
+					break;
+				p = SkipJsonValue(p, end);
+				if (!p)
+					return false;
+				p = SkipSpaces(p, end);
+				if (p == end || *p != ',')
+					return false;
+				p++;
+			}
+		}
+		if (p == end || *p != '[')
+			return false;
+
+		// The elements are arrays of numbers, so each ends at the next ], and the array at the first ] that follows one
+		outBegin = p + 1;
+		p = SkipSpaces(p + 1, end);
+		while (p < end && *p == '[') {
+			p = (const char*)memchr(p, ']', end - p);
+			if (!p)
+				return false;
+			p = SkipSpaces(p + 1, end);
+			if (p < end && *p == ']') {
+				outEnd = p;
+				return true;
+			}
+			if (p == end || *p != ',')
+				return false;
+			p = SkipSpaces(p + 1, end);
+		}
+		return false;
+	}
+
+	static const char* SkipSpaces(const char* p, const char* end)
+	{
+		while (p < end && IsSpace(*p))
+			p++;
+		return p;
+	}
+
+	// Returns the character past the end of the string starting with the quote at p, or null if it is not terminated
+	static const char* SkipJsonString(const char* p, const char* end)
+	{
+		for (p++; p < end; p++) {
+			if (*p == '\\')
+				p++;
+			else if (*p == '"')
+				return p + 1;
+		}
+		return nullptr;
+	}
+
+	// Returns the character past the end of the value starting at p, or null if it is not terminated
+	static const char* SkipJsonValue(const char* p, const char* end)
+	{
+		int depth = 0;
+		while (p < end) {
+			if (*p == '"') {
+				p = SkipJsonString(p, end);
+				if (!p || depth == 0)
+					return p;
+				continue;
+			}
+			if (*p == '[' || *p == '{')
+				depth++;
+			else if (*p == ']' || *p == '}') {
+				if (depth == 0)
+					return p;
+				if (--depth == 0)
+					return p + 1;
+			}
+			else if (*p == ',' && depth == 0)
+				return p;
+			p++;
+		}
+		return depth == 0 ? p : nullptr;
+	}
+
+	// A JSON record is an array that starts with a number
+	static size_t CountJson(const char* p, const char* end)
+	{
+		size_t count = 0;
+		while ((p = (const char*)memchr(p, '[', end - p)) != nullptr) {
+			p++;
+			while (p < end && IsSpace(*p))
+				p++;
+			if (p < end && IsNumberStart(*p))
+				count++;
+		}
+		return count;
+	}
+
+	static bool ParseJson(const char* p, const char* end, glm::vec3* points, glm::vec3* orientations, size_t count)
+	{
+		size_t parsed = 0;
+		while ((p = (const char*)memchr(p, '[', end - p)) != nullptr) {
+			p++;
+			while (p < end && IsSpace(*p))
+				p++;
+			if (p == end || !IsNumberStart(*p))
+				continue;
+
+			const char* recordEnd = (const char*)memchr(p, ']', end - p);
+			if (!recordEnd || parsed == count || !ParseRecord(p, recordEnd, ",", points[parsed], orientations[parsed]))
+				return false;
+			parsed++;
+			p = recordEnd + 1;
+		}
+		return parsed == count;
+	}
+
+	// Parses the 3 coordinates of a control point, and optionally 3 more of its orientation, from p to end
+	static bool ParseRecord(const char* p, const char* end, const char* separators, glm::vec3& outPoint, glm::vec3& outOrientation)
+	{
+		float values[6];
+		int count = 0;
+		while (true) {
+			while (p < end && (IsSpace(*p) || (*p && strchr(separators, *p))))
+				p++;
+			if (p == end)
+				break;
+			if (count == 6 || !ParseFloat(p, end, values[count]))
+				return false;
+			count++;
+		}
+		if (count != 3 && count != 6)
+			return false;
+
+		outPoint = glm::vec3(values[0], values[1], values[2]);
+		outOrientation = count == 6 ? glm::vec3(values[3], values[4], values[5]) : glm::vec3();
+		return true;
+	}
+
+	// Parses a float at p, and moves p past it
+	static bool ParseFloat(const char*& p, const char* end, float& outValue)
+	{
+		if (*p == '+')
+			p++;
+#ifdef SPLINE_IMPORTER_FROM_CHARS
+		std::from_chars_result result = std::from_chars(p, end, outValue);
+		if (result.ec != std::errc())
+			return false;
+		p = result.ptr;
+		return true;
+#else
+		// strtof needs a terminated string, and the mapped file is not, so the number is copied out first
+		char buffer[64];
+		size_t length = 0;
+		while (p + length < end && length < sizeof(buffer) - 1 && (IsNumberStart(p[length]) || p[length] == 'e' || p[length] == 'E'))
+			length++;
+		memcpy(buffer, p, length);
+		buffer[length] = 0;
+		char* parsedEnd;
+		outValue = strtof(buffer, &parsedEnd);
+		if (parsedEnd == buffer)
+			return false;
+		p += parsedEnd - buffer;
+		return true;
+#endif
+	}
+};
+
+#endif // !SPLINE_IMPORTER_H
@@ -0,0 +1,91 @@
+#ifndef SPLINE_SECTION_H
+#define SPLINE_SECTION_H
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include "glm/glm.hpp"
+#include "SplineBasis.h"
+
+// A section of a spline in the polynomial basis a + bt + ct^2 + dt^3, with its first derivative da + db t + dc t^2.
+// a, b, c, d come first and contiguous, as SplineBatchKernels reads them.
+struct SplineSectionCoefficients
+{
+	glm::vec3 a, b, c, d;
+	glm::vec3 da, db, dc;
+};
+
+// The math on a single section, shared by Spline and StreamingSpline, which only differ in how they keep their sections
+class SplineSection
+{
+public:
+
+	// Converts the section with the given 4 control points from the basis of the spline to the polynomial basis.
+	// The basis matrices are known at compile time, so their weights are folded into the code.
+	template <typename Basis>
+	static void CalculateCoefficients(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, SplineSectionCoefficients& outCoefficients)
+	{
+		typedef SplineBasisDerivative<Basis> Derivative;
+		outCoefficients.a = Basis::Matrix[0][0] * p0 + Basis::Matrix[0][1] * p1 + Basis::Matrix[0][2] * p2 + Basis::Matrix[0][3] * p3;
+		outCoefficients.b = Basis::Matrix[1][0] * p0 + Basis::Matrix[1][1] * p1 + Basis::Matrix[1][2] * p2 + Basis::Matrix[1][3] * p3;
+		outCoefficients.c = Basis::Matrix[2][0] * p0 + Basis::Matrix[2][1] * p1 + Basis::Matrix[2][2] * p2 + Basis::Matrix[2][3] * p3;
+		outCoefficients.d = Basis::Matrix[3][0] * p0 + Basis::Matrix[3][1] * p1 + Basis::Matrix[3][2] * p2 + Basis::Matrix[3][3] * p3;
+		outCoefficients.da = Derivative::Matrix[0][0] * p0 + Derivative::Matrix[0][1] * p1 + Derivative::Matrix[0][2] * p2 + Derivative::Matrix[0][3] * p3;
+		outCoefficients.db = Derivative::Matrix[1][0] * p0 + Derivative::Matrix[1][1] * p1 + Derivative::Matrix[1][2] * p2 + Derivative::Matrix[1][3] * p3;
+		outCoefficients.dc = Derivative::Matrix[2][0] * p0 + Derivative::Matrix[2][1] * p1 + Derivative::Matrix[2][2] * p2 + Derivative::Matrix[2][3] * p3;
+	}
+
+	// The value of the section for the given value of the parameter t [0, 1]
+	static glm::vec3 GetPoint(const SplineSectionCoefficients& section, float t)
+	{
+		return section.a + t * (section.b + t * (section.c + t * section.d));
+	}
+
+	// The (non-normalized) first derivative of the section
+	static glm::vec3 GetDerivative(const SplineSectionCoefficients& section, float t)
+	{
+		return section.da + t * (section.db + t * section.dc);
+	}
+
+	// The tangent of the section blended with the custom orientations of its ends, zero for none, eased in and out along it
+	static glm::vec3 GetOrientation(const SplineSectionCoefficients& section, float t, const glm::vec3& startOrientation, const glm::vec3& endOrientation)
+	{
+		glm::vec3 tangent = glm::normalize(GetDerivative(section, t));
+		glm::vec3 a = startOrientation != glm::vec3() ? startOrientation : tangent;
+		glm::vec3 b = endOrientation != glm::vec3() ? endOrientation : tangent;
+		t = (1 - cosf(float(t * M_PI))) * 0.5f;
+		return glm::normalize((1 - t) * a + t * b);
+	}
+
+	// Integrates the speed of the section from t0 to t1 with 5-point Gauss-Legendre quadrature,
+	//	which is exact for polynomials up to degree 9 and so very accurate between the samples of a section
+	static float GetArcLength(const SplineSectionCoefficients& section, float t0, float t1)
+	{
+		static const float nodes[5] = { 0.0f, -0.5384693101f, 0.5384693101f, -0.9061798459f, 0.9061798459f };
+		static const float weights[5] = { 0.5688888889f, 0.4786286705f, 0.4786286705f, 0.2369268851f, 0.2369268851f };
+		float half = (t1 - t0) * 0.5f, middle = (t0 + t1) * 0.5f;
+		float sum = 0.0f;
+		for (int k = 0; k < 5; k++)
+			sum += weights[k] * glm::length(GetDerivative(section, middle + half * nodes[k]));
+		return sum * half;
+	}
+
+	// Carries the up vector of a frame at x0 with forward vector f0 to the next one at x1 with forward vector f1,
+	//	reflecting it first across the plane bisecting x0 and x1, and then across the one that takes the reflected f0 onto f1.
+	static glm::vec3 TransportUp(const glm::vec3& x0, const glm::vec3& x1, glm::vec3 f0, const glm::vec3& f1, glm::vec3 up)
+	{
+		glm::vec3 v1 = x1 - x0;
+		float c1 = glm::dot(v1, v1);
+		if (c1 > 0.0f) {
+			up -= (2.0f / c1) * glm::dot(v1, up) * v1;
+			f0 -= (2.0f / c1) * glm::dot(v1, f0) * v1;
+		}
+		glm::vec3 v2 = f1 - f0;
+		float c2 = glm::dot(v2, v2);
+		if (c2 > 1e-12f) {
+			up -= (2.0f / c2) * glm::dot(v2, up) * v2;
+		}
+		return glm::normalize(up - glm::dot(up, f1) * f1);
+	}
+};
+
+#endif // !SPLINE_SECTION_H
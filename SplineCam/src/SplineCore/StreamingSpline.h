@@ -0,0 +1,372 @@
+#ifndef STREAMING_SPLINE_H
+#define STREAMING_SPLINE_H
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include "Spline.h"
+#include "SplineSection.h"
+
+// A source of control points read in order, a chunk at a time, e.g. from a file or a live feed
+class SplineChunkSource
+{
+public:
+	virtual ~SplineChunkSource() {}
+
+	// Reads up to count control points and their orientations, zero for none, and returns how many were read.
+	// A live source may return fewer, or none at all, until more arrive.
+	virtual size_t Read(glm::vec3* outControlPoints, glm::vec3* outOrientations, size_t count) = 0;
+
+	// Whether all the control points have been read, so there will never be more
+	virtual bool IsEnded() const = 0;
+};
+
+// Streams the control points of a spline file. The file is mapped, so only the pages being read are resident.
+class SplineFileChunkSource : public SplineChunkSource
+{
+public:
+
+	bool Open(const char* path)
+	{
+		next = 0;
+		return file.Open(path);
+	}
+
+	size_t Read(glm::vec3* outControlPoints, glm::vec3* outOrientations, size_t count) override
+	{
+		if (!file.IsOpen())
+			return 0;
+		count = std::min(count, file.ControlPointCount() - next);
+		std::copy(file.ControlPoints() + next, file.ControlPoints() + next + count, outControlPoints);
+		std::copy(file.Orientations() + next, file.Orientations() + next + count, outOrientations);
+		next += count;
+		return count;
+	}
+
+	bool IsEnded() const override { return !file.IsOpen() || next == file.ControlPointCount(); }
+
+private:
+
+	SplineFileView file;
+
+	// The index of the next control point to read
+	size_t next = 0;
+};
+
+// Generates the control points one at a time, with a function that returns false once there are no more
+class SplineGeneratorChunkSource : public SplineChunkSource
+{
+public:
+	typedef std::function<bool(glm::vec3& outControlPoint, glm::vec3& outOrientation)> Generator;
+
+	void Init(Generator generator_)
+	{
+		generator = generator_;
+		isEnded = false;
+	}
+
+	size_t Read(glm::vec3* outControlPoints, glm::vec3* outOrientations, size_t count) override
+	{
+		size_t read = 0;
+		while (read < count && !isEnded) {
+			outOrientations[read] = glm::vec3();
+			if (generator(outControlPoints[read], outOrientations[read]))
+				read++;
+			else
+				isEnded = true;
+		}
+		return read;
+	}
+
+	bool IsEnded() const override { return isEnded; }
+
+private:
+
+	Generator generator;
+	bool isEnded = true;
+};
+
+// A spline over an unbounded sequence of control points, of which only a sliding window is kept in memory.
+// The control points are pulled from a SplineChunkSource a chunk at a time as the position moves ahead, and the sections
+//	far enough behind it are dropped along with their control points, so live or very long tracks play back in constant memory.
+// The spline is clamped at its start, and at its end once the source is ended, so its sections are those of a Spline with the same control points.
+// As the number of sections is not known in advance, positions are given as s = i + t, the index of the section and the parameter t [0, 1] within it,
+//	or as the distance from the start of the spline, both in double precision so they stay exact far along the track.
+template <typename Basis = UniformBSplineBasis>
+class StreamingSpline
+{
+public:
+
+	// Starts streaming from the source, which must outlive the spline, reading chunkSize control points at a time.
+	// About chunkSize sections are kept ahead of the position, and up to twice as many behind it.
+	void Init(SplineChunkSource* source_, unsigned int chunkSize_ = 512)
+	{
+		source = source_;
+		chunkSize = chunkSize_ > 0 ? chunkSize_ : 1;
+		isSourceEnded = false;
+		controlPoints.clear();
+		orientations.clear();
+		sections.clear();
+		firstControlPoint = 0;
+		firstSection = 0;
+		Update(0.0);
+	}
+
+	// Moves the window to the position s: reads chunks until chunkSize sections lie ahead of it, or the source has none for now,
+	//	and drops the sections more than twice as many behind it. Call it as the position moves, as the other methods only read the window.
+	void Update(double s)
+	{
+		while (!isSourceEnded && EndSection() < s + chunkSize) {
+			chunkControlPoints.resize(chunkSize);
+			chunkOrientations.resize(chunkSize);
+			size_t read = source->Read(chunkControlPoints.data(), chunkOrientations.data(), chunkSize);
+			controlPoints.insert(controlPoints.end(), chunkControlPoints.begin(), chunkControlPoints.begin() + read);
+			orientations.insert(orientations.end(), chunkOrientations.begin(), chunkOrientations.begin() + read);
+			isSourceEnded = source->IsEnded();
+			CalculateSections();
+			if (read == 0)
+				break;
+		}
+
+		// Drop a chunk's worth of sections at a time, not to shift the window on every call
+		if (s - firstSection > 2.0 * chunkSize) {
+			size_t first = (size_t)s - chunkSize;
+			sections.erase(sections.begin(), sections.begin() + std::min(first - firstSection, sections.size()));
+			firstSection = first;
+
+			long long firstNeeded = (long long)Basis::Stride * first + Basis::Offset;
+			if (firstNeeded > (long long)firstControlPoint) {
+				size_t dropped = std::min((size_t)firstNeeded - firstControlPoint, controlPoints.size());
+				controlPoints.erase(controlPoints.begin(), controlPoints.begin() + dropped);
+				orientations.erase(orientations.begin(), orientations.begin() + dropped);
+				firstControlPoint += dropped;
+			}
+		}
+	}
+
+	// The sections in the window, from FirstSection to just before EndSection, and the distances along the spline they span
+	size_t FirstSection() const { return firstSection; }
+	size_t EndSection() const { return firstSection + sections.size(); }
+	double StartDistance() const { return sections.empty() ? 0.0 : sections.front().startDistance; }
+	double EndDistance() const { return sections.empty() ? 0.0 : sections.back().startDistance + sections.back().distances[FrameSampleCount]; }
+
+	// Whether the source is ended and all its sections were read, so EndSection is the end of the spline
+	bool IsEnded() const { return isSourceEnded; }
+
+	// The number of control points and sections in memory, bounded by the chunk size however long the spline is
+	size_t ResidentControlPoints() const { return controlPoints.size(); }
+	size_t ResidentSections() const { return sections.size(); }
+
+	// Returns the value of the spline at the position s, clamped to the window
+	glm::vec3 GetPoint(double s) const
+	{
+		if (sections.empty())
+			return glm::vec3();
+		float t;
+		const StreamingSection& section = FindSection(s, t);
+		return SplineSection::GetPoint(section, t);
+	}
+
+	// Returns the tangent of the spline at the position s, blended with the custom orientations as in Spline::GetTangent
+	glm::vec3 GetTangent(double s) const
+	{
+		if (sections.empty())
+			return glm::vec3(0.0f, 0.0f, 1.0f);
+		float t;
+		const StreamingSection& section = FindSection(s, t);
+		return GetOrientation(section, t);
+	}
+
+	// Returns the frame of the spline at the position s, as Spline::GetFrame: the up vector rolls as little as possible along the curve.
+	// It is transported along the spline as the sections are read, so it carries on from the sections dropped before them.
+	void GetFrame(double s, glm::vec3& forward, glm::vec3& up) const
+	{
+		if (sections.empty())
+			return;
+		float t;
+		const StreamingSection& section = FindSection(s, t);
+		float panel = t * FrameSampleCount;
+		int k = std::min((int)panel, FrameSampleCount - 1);
+		float f = panel - k;
+		forward = GetOrientation(section, t);
+		up = section.ups[k] + (section.ups[k + 1] - section.ups[k]) * f;
+		up = glm::normalize(up - glm::dot(up, forward) * forward);
+	}
+
+	// Returns the position s at the given distance from the start of the spline, clamped to the window.
+	// The section and its panel are found by their distances, and the parameter is refined with Newton steps on the arc length.
+	double GetParameterAtDistance(double distance) const
+	{
+		if (sections.empty())
+			return (double)firstSection;
+		distance = distance < StartDistance() ? StartDistance() : distance > EndDistance() ? EndDistance() : distance;
+
+		auto next = std::upper_bound(sections.begin(), sections.end(), distance,
+			[](double d, const StreamingSection& section) { return d < section.startDistance; });
+		size_t i = next == sections.begin() ? 0 : next - sections.begin() - 1;
+		const StreamingSection& section = sections[i];
+
+		float localDistance = (float)(distance - section.startDistance);
+		int k = (int)(std::upper_bound(section.distances, section.distances + FrameSampleCount + 1, localDistance) - section.distances) - 1;
+		k = k < 0 ? 0 : k < FrameSampleCount ? k : FrameSampleCount - 1;
+
+		float t0 = (float)k / FrameSampleCount, t1 = (float)(k + 1) / FrameSampleCount;
+		float panelLength = section.distances[k + 1] - section.distances[k];
+		float target = localDistance - section.distances[k];
+		float t = t0 + (panelLength > 0.0f ? (t1 - t0) * target / panelLength : 0.0f);
+
+		// The root stays bracketed, and a step that would leave the bracket bisects it instead, for panels whose speed varies a lot
+		float low = t0, high = t1;
+		for (int step = 0; step < 16 && target > 0.0f; step++) {
+			float error = SplineSection::GetArcLength(section, t0, t) - target;
+			if (error > 0.0f)
+				high = t;
+			else
+				low = t;
+			float slope = glm::length(SplineSection::GetDerivative(section, t));
+			float next = slope > 0.0f ? t - error / slope : low - 1.0f;
+			next = next > low && next < high ? next : (low + high) * 0.5f;
+			if (fabsf(next - t) < 1e-6f)
+				break;
+			t = next;
+		}
+		return firstSection + i + (double)t;
+	}
+
+	// Returns the distance from the start of the spline at the position s, clamped to the window
+	double GetDistanceAtParameter(double s) const
+	{
+		if (sections.empty())
+			return 0.0;
+		float t;
+		const StreamingSection& section = FindSection(s, t);
+		int k = std::min((int)(t * FrameSampleCount), FrameSampleCount - 1);
+		float arc = SplineSection::GetArcLength(section, (float)k / FrameSampleCount, t);
+		arc = std::min(arc, section.distances[k + 1] - section.distances[k]);
+		return section.startDistance + section.distances[k] + arc;
+	}
+
+private:
+
+	// Every section is split into this many panels of equal parameter, at whose ends its arc length and up vector are kept
+	static constexpr int FrameSampleCount = 8;
+
+	// The largest angle in radians the forward vector may turn by in each step of the transport of the up vector
+	static constexpr float MaximumTransportAngle = 0.05f;
+
+	// A section in the window: its polynomial a + bt + ct^2 + dt^3 and derivative da + db t + dc t^2, the custom orientations of
+	//	the control points it goes from and to, its distance from the start of the spline, and its arc length and up vector at the end of each panel
+	struct StreamingSection : SplineSectionCoefficients
+	{
+		glm::vec3 startOrientation, endOrientation;
+		double startDistance;
+		float distances[FrameSampleCount + 1];
+		glm::vec3 ups[FrameSampleCount + 1];
+	};
+
+	// Returns the section at the position s, clamped to the window, and the parameter t [0, 1] within it
+	const StreamingSection& FindSection(double s, float& outT) const
+	{
+		double last = (double)EndSection();
+		s = s < firstSection ? firstSection : s > last ? last : s;
+		size_t i = std::min((size_t)s - firstSection, sections.size() - 1);
+		outT = (float)(s - firstSection - i);
+		return sections[i];
+	}
+
+	// The control point at the given index of the whole spline, clamped to the first one, and to the last one once the source is ended
+	const glm::vec3& GetControlPoint(const std::deque<glm::vec3>& points, long long i) const
+	{
+		long long last = (long long)(firstControlPoint + controlPoints.size()) - 1;
+		i = i < 0 ? 0 : i > last ? last : i;
+		return points[(size_t)(i - firstControlPoint)];
+	}
+
+	// Computes the sections whose control points were all read since the last call, carrying the distance and the up vector over from the previous one
+	void CalculateSections()
+	{
+		size_t readControlPoints = firstControlPoint + controlPoints.size();
+		for (size_t i = EndSection();; i++) {
+			long long first = (long long)Basis::Stride * i + Basis::Offset;
+			if (isSourceEnded ? (long long)i >= Basis::SectionCount((int)readControlPoints, false) : first + 3 >= (long long)readControlPoints)
+				break;
+
+			StreamingSection section;
+			SplineSection::CalculateCoefficients<Basis>(GetControlPoint(controlPoints, first), GetControlPoint(controlPoints, first + 1),
+				GetControlPoint(controlPoints, first + 2), GetControlPoint(controlPoints, first + 3), section);
+			section.startOrientation = GetControlPoint(orientations, first + Basis::SectionStart);
+			section.endOrientation = GetControlPoint(orientations, first + Basis::SectionEnd);
+
+			section.distances[0] = 0.0f;
+			for (int k = 1; k <= FrameSampleCount; k++)
+				section.distances[k] = section.distances[k - 1] + SplineSection::GetArcLength(section, (float)(k - 1) / FrameSampleCount, (float)k / FrameSampleCount);
+
+			// The frames carry on from the end of the previous section, or start with the up vector closest to the Y axis
+			glm::vec3 forward = GetOrientation(section, 0.0f);
+			glm::vec3 point = section.a;
+			if (sections.empty()) {
+				section.startDistance = 0.0;
+				glm::vec3 up = fabsf(forward.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+				section.ups[0] = glm::normalize(up - glm::dot(up, forward) * forward);
+			}
+			else {
+				const StreamingSection& previous = sections.back();
+				section.startDistance = previous.startDistance + previous.distances[FrameSampleCount];
+				section.ups[0] = glm::normalize(previous.ups[FrameSampleCount] - glm::dot(previous.ups[FrameSampleCount], forward) * forward);
+			}
+			// Within each panel, the up vector is transported in steps small enough for the forward vector to barely turn in each,
+			//	as where a section bends sharply the transport would otherwise depend on how it is sampled
+			glm::vec3 up = section.ups[0];
+			for (int k = 1; k <= FrameSampleCount; k++) {
+				float t0 = (float)(k - 1) / FrameSampleCount;
+				glm::vec3 panelForward = GetOrientation(section, (float)k / FrameSampleCount);
+				int steps = 1 + std::min((int)(acosf(glm::clamp(glm::dot(forward, panelForward), -1.0f, 1.0f)) / MaximumTransportAngle), 63);
+				for (int step = 1; step <= steps; step++) {
+					float t = t0 + (float)step / (steps * FrameSampleCount);
+					glm::vec3 nextPoint = SplineSection::GetPoint(section, t);
+					glm::vec3 nextForward = GetOrientation(section, t);
+					up = SplineSection::TransportUp(point, nextPoint, forward, nextForward, up);
+					point = nextPoint;
+					forward = nextForward;
+				}
+				section.ups[k] = up;
+			}
+
+			sections.push_back(section);
+		}
+	}
+
+	// The tangent blended with the custom orientations of the ends of the section
+	static glm::vec3 GetOrientation(const StreamingSection& section, float t)
+	{
+		return SplineSection::GetOrientation(section, t, section.startOrientation, section.endOrientation);
+	}
+
+	SplineChunkSource* source = nullptr;
+
+	// The number of control points read at a time, and whether the source has no more
+	unsigned int chunkSize = 512;
+	bool isSourceEnded = true;
+
+	// The control points read and not yet dropped, and the index in the whole spline of the first one
+	std::deque<glm::vec3> controlPoints;
+	std::deque<glm::vec3> orientations;
+	size_t firstControlPoint = 0;
+
+	// The sections in the window, and the index in the whole spline of the first one
+	std::deque<StreamingSection> sections;
+	size_t firstSection = 0;
+
+	// The buffers each chunk is read into, kept to reuse their memory
+	std::vector<glm::vec3> chunkControlPoints;
+	std::vector<glm::vec3> chunkOrientations;
+};
+
+// The instantiations for the provided bases are compiled once, in SplineCore.cpp
+extern template class StreamingSpline<UniformBSplineBasis>;
+extern template class StreamingSpline<CatmullRomBasis>;
+extern template class StreamingSpline<BezierBasis>;
+extern template class StreamingSpline<HermiteBasis>;
+
+#endif // !STREAMING_SPLINE_H
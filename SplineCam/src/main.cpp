@@ -9,6 +9,7 @@
 #include "SplineCam/SplineCam.h"
 
 #include <chrono>
+#include <string>
 
 int main()
 {
@@ -20,9 +21,9 @@ int main()
 	}
 
 	// set window configuration
-	//glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	//glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	//glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE); // only support modern opengl
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE); // only support modern opengl
 
 	// create the window
 	GLFWwindow* window = glfwCreateWindow(1024, 768, "SplineCam", nullptr, nullptr);
@@ -58,6 +59,7 @@ int main()
 	const auto frameCap = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::duration<long, std::ratio<1, 60>>(1));
 	auto deltaTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::microseconds::zero());
 	auto previousTime = std::chrono::steady_clock::now();
+	auto previousTitleTime = previousTime;
 
 	// main loop
 	while (!glfwWindowShouldClose(window))
@@ -78,6 +80,14 @@ int main()
 
 			glfwSwapBuffers(window);
 
+			// show the effect of the frustum culling in the title, once per second
+			if (currentTime - previousTitleTime > std::chrono::seconds(1))
+			{
+				std::string title = "SplineCam - cubes visible: " + std::to_string(splineCam.VisibleCubeCount()) + ", culled: " + std::to_string(splineCam.CulledCubeCount());
+				glfwSetWindowTitle(window, title.c_str());
+				previousTitleTime = currentTime;
+			}
+
 			deltaTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::microseconds::zero());
 		}
 	}
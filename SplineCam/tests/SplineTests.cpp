@@ -0,0 +1,283 @@
+// Regression tests of SplineCore, linked against the headless SplineCore library only.
+//
+// Usage: SplineTests
+//	Runs every test, prints the failed checks, and returns 1 if any failed.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "SplineCore/Spline.h"
+#include "SplineCore/SplineFile.h"
+#include "SplineCore/SplineImporter.h"
+#include "SplineCore/SplineDecimator.h"
+
+static int s_failureCount = 0;
+static const char* s_testName = "";
+
+// Records a failed check, with the test and the line it is on
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::cerr << s_testName << ":" << __LINE__ << ": " << #condition << std::endl; \
+			s_failureCount++; \
+		} \
+	} while (0)
+
+static const char* s_tempPath = "SplineTests.tmp";
+
+void WriteFile(const char* path, const std::string& contents)
+{
+	std::ofstream file(path, std::ios::binary);
+	file << contents;
+}
+
+std::string ReadFile(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+std::vector<glm::vec3> MakePoints(size_t count)
+{
+	std::vector<glm::vec3> points(count);
+	for (size_t i = 0; i < count; i++)
+		points[i] = glm::vec3(10.0f * cosf(i * 0.7f), 2.0f * sinf(i * 0.3f), i * 3.0f);
+	return points;
+}
+
+// A file whose section offsets go backwards must be rejected, even where the offset plus the two end points wraps around
+void TestSplineFileRejectsWrappedOffsets()
+{
+	Spline<> spline;
+	spline.Init(MakePoints(8));
+	CHECK(spline.Save(s_tempPath));
+	{
+		SplineFileView view;
+		CHECK(view.Open(s_tempPath));
+	}
+
+	std::string contents = ReadFile(s_tempPath);
+	const SplineFileHeader& header = *(const SplineFileHeader*)contents.data();
+	CHECK(header.sectionCount >= 2);
+	unsigned int* offsets = (unsigned int*)&contents[(size_t)header.sectionOffsets];
+	offsets[1] = 0xFFFFFFFFu;
+	WriteFile(s_tempPath, contents);
+
+	SplineFileView view;
+	CHECK(!view.Open(s_tempPath));
+	CHECK(!view.IsOpen());
+	remove(s_tempPath);
+}
+
+// Deleting a control point returns the parameter of the same point of the curve, for the sections it leaves as they were
+template <typename Basis>
+void TestDeleteControlPointKeepsPosition()
+{
+	for (bool isCyclic : { false, true }) {
+		Spline<Basis> spline;
+		spline.Init(MakePoints(13), std::vector<glm::vec3>(), isCyclic);
+		int sections = Basis::SectionCount(13, isCyclic);
+
+		// The first section, before the deleted control point, and with a sliding window, the one before the last, past it
+		std::vector<float> parameters = { 0.5f / sections };
+		if (Basis::Stride == 1)
+			parameters.push_back((sections - 2.5f) / sections);
+		for (float t : parameters) {
+			Spline<Basis> edited = spline;
+			edited.SelectControlPoint(6);
+			glm::vec3 point = spline.GetPoint(t);
+			float newT = edited.DeleteControlPoint(t);
+			CHECK(newT >= 0.0f && newT <= 1.0f);
+			CHECK(glm::length(edited.GetPoint(newT) - point) < 1e-3f);
+		}
+
+		// Deleting from every control point in turn stays in range
+		Spline<Basis> edited = spline;
+		float t = 0.5f;
+		while (edited.ControlPoints().size() > 2) {
+			t = edited.DeleteControlPoint(t);
+			CHECK(t >= 0.0f && t <= 1.0f);
+		}
+	}
+}
+
+// Only the elements of the array of points are imported, not the other numeric arrays of the document
+void TestImportJsonSkipsOtherMembers()
+{
+	std::vector<glm::vec3> points, orientations;
+	WriteFile(s_tempPath, "{ \"origin\": [100, 200, 300], \"name\": \"a [1, 2] \\\" b\", \"meta\": { \"points\": [[7, 8, 9]] },\n"
+		"  \"points\": [ [1, 2, 3], [4, 5, 6, 0, 0, 1], [7, 8, 9] ],\n"
+		"  \"scale\": [1, 2] }\n");
+	CHECK(SplineImporter::Import(s_tempPath, points, orientations));
+	CHECK(points.size() == 3);
+	if (points.size() == 3) {
+		CHECK(points[0] == glm::vec3(1, 2, 3) && points[1] == glm::vec3(4, 5, 6) && points[2] == glm::vec3(7, 8, 9));
+		CHECK(orientations[0] == glm::vec3() && orientations[1] == glm::vec3(0, 0, 1));
+	}
+
+	WriteFile(s_tempPath, "[[1, 2, 3], [4, 5, 6]]");
+	CHECK(SplineImporter::Import(s_tempPath, points, orientations));
+	CHECK(points.size() == 2);
+
+	WriteFile(s_tempPath, "{ \"origin\": [100, 200, 300] }");
+	CHECK(!SplineImporter::Import(s_tempPath, points, orientations));
+	CHECK(points.empty());
+
+	// Big enough to be split between threads, with a numeric array on either side
+	std::string contents = "{ \"meta\": [1, 2], \"points\": [\n";
+	const size_t count = 200000;
+	for (size_t i = 0; i < count; i++)
+		contents += "[" + std::to_string(i) + ", 0.5, -2]" + (i + 1 < count ? ",\n" : "\n");
+	contents += "], \"bounds\": [[0, 0, 0], [1, 1, 1]] }\n";
+	WriteFile(s_tempPath, contents);
+	CHECK(SplineImporter::Import(s_tempPath, points, orientations, 4));
+	CHECK(points.size() == count);
+	if (points.size() == count)
+		CHECK(points[0] == glm::vec3(0, 0.5f, -2) && points[count - 1] == glm::vec3((float)(count - 1), 0.5f, -2));
+	remove(s_tempPath);
+}
+
+// The largest distance from the points of the spline, densely sampled, to the other spline
+float GetFarthestDistance(const Spline<>& spline, const Spline<>& other, size_t samples)
+{
+	std::vector<glm::vec3> points(samples);
+	for (size_t k = 0; k < samples; k++)
+		points[k] = spline.GetPoint((float)k / (samples - 1));
+	std::vector<SplineProjection> projections(samples);
+	other.ClosestPoints(points.data(), samples, projections.data());
+	float distance = 0.0f;
+	for (const SplineProjection& projection : projections)
+		distance = std::max(distance, projection.distance);
+	return distance;
+}
+
+// The error returned by the decimator bounds the Hausdorff distance between the curves, measured on a random walk, which it barely simplifies
+void TestDecimateBoundsError()
+{
+	unsigned int seed = 47514;
+	auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / 16777216.0f - 0.5f; };
+	std::vector<glm::vec3> points(2000), decimatedPoints, decimatedOrientations;
+	for (size_t i = 1; i < points.size(); i++)
+		points[i] = points[i - 1] + glm::vec3(random(), random(), random());
+
+	const float tolerance = 0.05f;
+	float error = SplineDecimator<>::Decimate(points, std::vector<glm::vec3>(), false, tolerance, decimatedPoints, decimatedOrientations);
+	CHECK(error <= tolerance);
+	CHECK(decimatedPoints.size() < points.size());
+
+	Spline<> spline, decimated;
+	spline.Init(points);
+	decimated.Init(decimatedPoints, decimatedOrientations);
+	float distance = std::max(GetFarthestDistance(spline, decimated, points.size() * 32), GetFarthestDistance(decimated, spline, points.size() * 32));
+	CHECK(distance <= error);
+}
+
+// The batched points match GetPoint, with or without the derivatives, for a count that leaves a remainder for the scalar kernel
+void TestEvaluateBatchMatchesGetPoint()
+{
+	Spline<> spline;
+	spline.Init(MakePoints(50));
+	const size_t count = 1027;
+	std::vector<float> parameters(count), x(count), y(count), z(count), tangentX(count), tangentY(count), tangentZ(count);
+	for (size_t k = 0; k < count; k++)
+		parameters[k] = k * 1.1f / (count - 1) - 0.05f;
+
+	for (bool withTangents : { false, true }) {
+		SplineBatchOutput output;
+		output.x = x.data(); output.y = y.data(); output.z = z.data();
+		if (withTangents) {
+			output.tangentX = tangentX.data(); output.tangentY = tangentY.data(); output.tangentZ = tangentZ.data();
+		}
+		spline.EvaluateBatch(parameters.data(), count, output);
+		float error = 0.0f;
+		for (size_t k = 0; k < count; k++)
+			error = std::max(error, glm::length(glm::vec3(x[k], y[k], z[k]) - spline.GetPoint(parameters[k])));
+		CHECK(error < 1e-4f);
+	}
+}
+
+// A copy of the points, control points and indices of the levels of detail of a spline, kept up to date from its changes only,
+//	as SplineRenderer keeps its buffers, stays equal to the spline through moves, turns, insertions and deletions of control points
+void TestChangesKeepCopyInStep()
+{
+	unsigned int seed = 12345;
+	auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / 16777216.0f - 0.5f; };
+	Spline<> spline;
+	spline.Init(MakePoints(40));
+	std::vector<glm::vec3> points = spline.GetSplinePoints(), controlPoints = spline.ControlPoints(), orientations = spline.Orientations();
+	std::vector<unsigned int> indices = spline.GetLevelOfDetailIndices();
+	unsigned int revision = spline.Revision(), compactions = spline.LevelOfDetailCompactions();
+	std::vector<unsigned int> changedSections, changedControlPoints;
+	int partialCount = 0;
+
+	for (int edit = 0; edit < 400; edit++) {
+		spline.SelectControlPoint((unsigned int)((random() + 0.5f) * spline.ControlPoints().size()));
+		if (edit % 50 == 49)
+			spline.CreateControlPoint(random() + 0.5f);
+		else if (edit % 50 == 24)
+			spline.DeleteControlPoint(0.5f);
+		else if (edit % 3 == 0)
+			spline.RotateControlPoint(random(), random());
+		else
+			spline.TranslateControlPoint(glm::vec3(random(), random(), random()) * (edit % 7 == 0 ? 20.0f : 0.5f));
+
+		const std::vector<unsigned int>& sectionOffsets = spline.GetSectionOffsets();
+		if (spline.GetChangesSince(revision, changedSections, changedControlPoints)) {
+			partialCount++;
+			for (unsigned int i : changedSections)
+				std::copy(spline.GetSplinePoints().begin() + sectionOffsets[i], spline.GetSplinePoints().begin() + sectionOffsets[i + 1], points.begin() + sectionOffsets[i]);
+			for (unsigned int i : changedControlPoints) {
+				controlPoints[i] = spline.ControlPoints()[i];
+				orientations[i] = spline.Orientations()[i];
+			}
+		}
+		else {
+			points = spline.GetSplinePoints();
+			controlPoints = spline.ControlPoints();
+			orientations = spline.Orientations();
+		}
+		revision = spline.Revision();
+		CHECK(points == spline.GetSplinePoints());
+		CHECK(controlPoints == spline.ControlPoints() && orientations == spline.Orientations());
+
+		// Request some levels of detail, then copy only the indices appended since, unless they were compacted
+		for (unsigned int i = edit % 4; i + 1 < sectionOffsets.size(); i += 4) {
+			unsigned int first, count;
+			spline.GetSectionLevelOfDetail(i, 1 + i % (Spline<>::LevelOfDetailCount - 1), first, count);
+		}
+		const std::vector<unsigned int>& newIndices = spline.GetLevelOfDetailIndices();
+		if (spline.LevelOfDetailCompactions() != compactions || newIndices.size() < indices.size())
+			indices.clear();
+		indices.insert(indices.end(), newIndices.begin() + indices.size(), newIndices.end());
+		compactions = spline.LevelOfDetailCompactions();
+		CHECK(indices == newIndices);
+	}
+	CHECK(partialCount > 200);
+}
+
+int main()
+{
+	struct Test { const char* name; void (*run)(); };
+	const Test tests[] = {
+		{ "spline_file_rejects_wrapped_offsets", TestSplineFileRejectsWrappedOffsets },
+		{ "delete_control_point_b_spline", TestDeleteControlPointKeepsPosition<UniformBSplineBasis> },
+		{ "delete_control_point_catmull_rom", TestDeleteControlPointKeepsPosition<CatmullRomBasis> },
+		{ "delete_control_point_bezier", TestDeleteControlPointKeepsPosition<BezierBasis> },
+		{ "delete_control_point_hermite", TestDeleteControlPointKeepsPosition<HermiteBasis> },
+		{ "import_json_skips_other_members", TestImportJsonSkipsOtherMembers },
+		{ "decimate_bounds_error", TestDecimateBoundsError },
+		{ "evaluate_batch_matches_get_point", TestEvaluateBatchMatchesGetPoint },
+		{ "changes_keep_copy_in_step", TestChangesKeepCopyInStep },
+	};
+
+	for (const Test& test : tests) {
+		s_testName = test.name;
+		int failureCount = s_failureCount;
+		test.run();
+		std::cout << (s_failureCount == failureCount ? "pass  " : "FAIL  ") << test.name << std::endl;
+	}
+	return s_failureCount ? 1 : 0;
+}